@@ -43,4 +43,5 @@ namespace SWE::Papyrus {
     float GetSubmergedLevel(RE::StaticFunctionTag*, RE::Actor* a);
     bool IsWetWeatherAround(RE::StaticFunctionTag*, RE::Actor* a);
     std::int32_t GetEnvMask(RE::StaticFunctionTag*, RE::Actor* a);
+    float GetPerfCounter(RE::StaticFunctionTag*, std::int32_t counter, bool perSecond);
 }
@@ -1,6 +1,9 @@
 ﻿#pragma once
+#include <algorithm>
 #include <atomic>
+#include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace Settings {
@@ -14,81 +17,185 @@ namespace Settings {
         bool autoWet{true};
     };
 
-    extern std::atomic<bool> modEnabled;
-    extern std::atomic<bool> affectNPCs;
-    extern std::atomic<int> npcRadius;
-    extern std::atomic<bool> npcOptInOnly;
-
-    extern std::atomic<bool> rainEnabled;
-    extern std::atomic<bool> snowEnabled;
-    extern std::atomic<bool> affectInSnow;
-    extern std::atomic<bool> ignoreInterior;
-
-    extern std::atomic<bool> affectSkin;
-    extern std::atomic<bool> affectHair;
-    extern std::atomic<bool> affectArmor;
-    extern std::atomic<bool> affectWeapons;
-
-    extern std::atomic<float> secondsToSoakWater;
-    extern std::atomic<float> secondsToSoakRain;
-    extern std::atomic<float> secondsToSoakSnow;
-    extern std::atomic<float> secondsToDrySkin;
-    extern std::atomic<float> secondsToDryHair;
-    extern std::atomic<float> secondsToDryArmor;
-    extern std::atomic<float> secondsToDryWeapon;
-    extern std::atomic<float> minSubmergeToSoak;
-
-    extern std::atomic<float> glossinessBoost;      // added to original glossiness * wetness
-    extern std::atomic<float> specularScaleBoost;   // (1 + wet * this) multiplier
-    extern std::atomic<float> maxGlossiness;        // hard clamp (e.g. 300)
-    extern std::atomic<float> maxSpecularStrength;  // clamp for color channels (0...something)
-    extern std::atomic<float> minGlossiness;        // below this is considered non-glossy
-    extern std::atomic<float> minSpecularStrength;  // below this is considered non-specular
-
-    extern std::atomic<bool> waterfallEnabled;
-    extern std::atomic<float> secondsToSoakWaterfall;
-    extern std::atomic<float> nearWaterfallRadius;
-    extern std::atomic<float> waterfallWidthPad;  // X
-    extern std::atomic<float> waterfallDepthPad;  // Y
-    extern std::atomic<float> waterfallZPad;
-
-    extern std::atomic<float> nearFireRadius;
-    extern std::atomic<float> dryMultiplierNearFire;
-
-    extern std::atomic<float> skinHairResponseMul;
-
-    extern std::atomic<int> externalBlendMode;  // 0=Max,1=Add,2=MaxPlusWeightedRest
-    extern std::atomic<float> externalAddWeight;
-
-    extern std::atomic<int> updateIntervalMs;
-
-    extern std::atomic<bool> pbrFriendlyMode;
-    extern std::atomic<float> pbrArmorWeapMul;
-    extern std::atomic<float> pbrMaxGlossArmor;
-    extern std::atomic<float> pbrMaxSpecArmor;
-
-    extern std::atomic<bool> pbrClearcoatOnWet;   // default false
-    extern std::atomic<float> pbrClearcoatScale;  // default 0.35f
-    extern std::atomic<float> pbrClearcoatSpec;
-
-    // Activity-based wetness (sweat) – optional
-    extern std::atomic<bool> activityWetEnabled;
-    extern std::atomic<bool> activityTriggerRunning;
-    extern std::atomic<bool> activityTriggerSneaking;
-    extern std::atomic<bool> activityTriggerWorking;
-
-    // 4-bit cat mask (default: Skin only = 0x01)
-    extern std::atomic<int> activityCatMask;
-
-    // Soak/Dry times for activity wetness (independent von Rain/Water)
-    extern std::atomic<float> secondsToSoakActivity;
-    extern std::atomic<float> secondsToDryActivity;
+    // Every scalar setting: X(type, name, initial value, ResetToDefaults value). The JSON key is the name.
+    // Declarations, definitions, load, save, reset and the Config fields below are all generated from this table.
+    #define SWE_SETTINGS(X)                                                                                          \
+        X(bool, modEnabled, true, true)                                                                              \
+        X(bool, affectNPCs, false, false)                                                                            \
+        X(int, npcRadius, 4096, 4096)                                                                                \
+        X(bool, npcOptInOnly, false, false)                                                                          \
+                                                                                                                     \
+        X(bool, rainEnabled, true, false)                                                                            \
+        X(bool, snowEnabled, true, false)                                                                            \
+        X(bool, affectInSnow, false, false)                                                                          \
+        X(bool, ignoreInterior, true, true)                                                                          \
+                                                                                                                     \
+        X(bool, affectSkin, true, true)                                                                              \
+        X(bool, affectHair, true, true)                                                                              \
+        X(bool, affectArmor, true, true)                                                                             \
+        X(bool, affectWeapons, true, true)                                                                           \
+                                                                                                                     \
+        X(float, secondsToSoakWater, 2.0f, 6.0f)                                                                     \
+        X(float, secondsToSoakRain, 36.0f, 1450.0f)                                                                  \
+        X(float, secondsToSoakSnow, 48.0f, 2100.0f)                                                                  \
+        X(float, secondsToDrySkin, 40.0f, 1600.0f)                                                                   \
+        X(float, secondsToDryHair, 40.0f, 1900.0f)                                                                   \
+        X(float, secondsToDryArmor, 40.0f, 2200.0f)                                                                  \
+        X(float, secondsToDryWeapon, 40.0f, 2000.0f)                                                                 \
+        X(float, minSubmergeToSoak, 0.5f, 0.5f)                                                                      \
+                                                                                                                     \
+        X(float, glossinessBoost, 120.0f, 120.0f)     /* added to original glossiness * wetness */                   \
+        X(float, specularScaleBoost, 8.0f, 8.0f)      /* (1 + wet * this) multiplier */                              \
+        X(float, maxGlossiness, 800.0f, 800.0f)       /* hard clamp (e.g. 300) */                                    \
+        X(float, maxSpecularStrength, 10.0f, 10.0f)   /* clamp for color channels (0...something) */                 \
+        X(float, minGlossiness, 0.0f, 0.0f)           /* below this is considered non-glossy */                      \
+        X(float, minSpecularStrength, 0.0f, 0.0f)     /* below this is considered non-specular */                    \
+                                                                                                                     \
+        X(bool, waterfallEnabled, false, false)                                                                      \
+        X(float, secondsToSoakWaterfall, 8.0f, 8.0f)                                                                 \
+        X(float, nearWaterfallRadius, 128.0f, 512.0f)                                                                \
+        X(float, waterfallWidthPad, 45.0f, 45.0f)     /* X */                                                        \
+        X(float, waterfallDepthPad, 64.0f, 64.0f)     /* Y */                                                        \
+        X(float, waterfallZPad, 51.0f, 51.0f)                                                                        \
+                                                                                                                     \
+        X(float, nearFireRadius, 512.0f, 512.0f)                                                                     \
+        X(float, dryMultiplierNearFire, 3.0f, 8.0f)                                                                  \
+                                                                                                                     \
+        X(float, skinHairResponseMul, 5.0f, 5.0f)                                                                    \
+                                                                                                                     \
+        X(int, externalBlendMode, 0, 0)               /* 0=Max,1=Add,2=MaxPlusWeightedRest */                        \
+        X(float, externalAddWeight, 0.5f, 0.5f)                                                                      \
+        X(float, modEventThreshold, 0.0f, 0.0f)       /* SWE_WetnessChanged ModEvent, 0 = off */                     \
+        X(float, modEventHysteresis, 0.05f, 0.05f)                                                                   \
+        X(bool, modEventPlayerOnly, true, true)                                                                      \
+        X(bool, sharedTableEnabled, false, false)                                                                    \
+        X(int, sharedTableMaxActors, 256, 256)        /* rows in the shared-memory table */                          \
+                                                                                                                     \
+        X(int, updateIntervalMs, 50, 50)                                                                             \
+        X(int, maxGeomAppliesPerTick, 96, 96)         /* 0 = unlimited */                                            \
+        X(bool, deferOffscreenApplies, false, false)                                                                 \
+        X(int, saveMaxActors, 1024, 1024)             /* actors kept in the co-save, 0 = unlimited */                \
+        X(int, saveMaxSourcesPerActor, 16, 16)        /* strongest external sources kept, 0 = unlimited */           \
+        X(int, coldMaxActors, 4096, 4096)             /* unloaded wet actors remembered, 0 = unlimited */            \
+        X(int, coldMaxAgeMin, 240, 240)               /* minutes an unloaded actor is remembered, 0 = forever */     \
+                                                                                                                     \
+        X(bool, pbrFriendlyMode, false, false)                                                                       \
+        X(float, pbrArmorWeapMul, 0.5f, 0.5f)                                                                        \
+        X(float, pbrMaxGlossArmor, 300.0f, 300.0f)                                                                   \
+        X(float, pbrMaxSpecArmor, 5.0f, 5.0f)                                                                        \
+                                                                                                                     \
+        X(bool, pbrClearcoatOnWet, false, false)                                                                     \
+        X(float, pbrClearcoatScale, 0.35f, 0.35f)                                                                    \
+        X(float, pbrClearcoatSpec, 0.25f, 0.25f)                                                                     \
+                                                                                                                     \
+        /* Activity-based wetness (sweat) - optional */                                                              \
+        X(bool, activityWetEnabled, false, false)                                                                    \
+        X(bool, activityTriggerRunning, true, true)                                                                  \
+        X(bool, activityTriggerSneaking, true, true)                                                                 \
+        X(bool, activityTriggerWorking, true, true)                                                                  \
+        X(int, activityCatMask, 0x01, 0x01)           /* 4-bit cat mask (default: Skin only) */                      \
+        /* Soak/Dry times for activity wetness (independent of rain/water) */                                        \
+        X(float, secondsToSoakActivity, 40.0f, 40.0f) /* 0->100% under sustained activity */                         \
+        X(float, secondsToDryActivity, 35.0f, 35.0f)
+
+    #define SWE_DECLARE_SETTING(T, name, init, reset) extern std::atomic<T> name;
+    SWE_SETTINGS(SWE_DECLARE_SETTING)
+    #undef SWE_DECLARE_SETTING
+
+    // Immutable view of every setting plus the values the tick derives from them. Rebuilt only when a setting
+    // changes, so the tick reads one pointer instead of dozens of atomics per actor and geometry.
+    struct Config {
+        std::uint64_t version{0};
+
+    #define SWE_CONFIG_FIELD(T, name, init, reset) T name{init};
+        SWE_SETTINGS(SWE_CONFIG_FIELD)
+    #undef SWE_CONFIG_FIELD
+
+        // Derived
+        float soakWaterRate{0.f};  // 1/s, 1 when the time is ~0
+        float soakRainRate{0.f};
+        float soakSnowRate{0.f};
+        float soakWaterfallRate{0.f};
+        float soakActivityRate{0.f};
+        float dryActivityRate{0.f};
+        float dryRate[4]{};              // per category, 0=Skin, 1=Hair, 2=Armor, 3=Weapon
+        std::uint8_t catEnabledMask{0};  // affectSkin..affectWeapons as bits
+        std::uint8_t activityMask{0};
+        float minSubmerge{0.f};  // clamped to [0, 0.99]
+        float heatRadius{0.f};   // nearFireRadius, at least 50
+        float heatDryMul{1.f};   // dryMultiplierNearFire, at least 1
+        float waterfallRadiusSq{0.f};
+        float waterfallMaxDz{0.f};
+        float waterfallPad[3]{};  // width, depth, z; non-negative
+        int tickIntervalMs{10};   // updateIntervalMs, at least 10
+    };
 
+    // Computes the derived fields of c from its settings. Inline so the headless tools can rebuild a Config.
+    inline void DeriveConfig(Config& c) {
+        const auto rateOf = [](float seconds) { return (seconds > 0.01f) ? (1.f / seconds) : 1.0f; };
+        c.soakWaterRate = rateOf(c.secondsToSoakWater);
+        c.soakRainRate = rateOf(c.secondsToSoakRain);
+        c.soakSnowRate = rateOf(c.secondsToSoakSnow);
+        c.soakWaterfallRate = rateOf(c.secondsToSoakWaterfall);
+        c.soakActivityRate = rateOf(c.secondsToSoakActivity);
+        c.dryActivityRate = rateOf(c.secondsToDryActivity);
+        c.dryRate[0] = rateOf(c.secondsToDrySkin);
+        c.dryRate[1] = rateOf(c.secondsToDryHair);
+        c.dryRate[2] = rateOf(c.secondsToDryArmor);
+        c.dryRate[3] = rateOf(c.secondsToDryWeapon);
+        c.catEnabledMask = static_cast<std::uint8_t>((c.affectSkin ? 1u : 0u) | (c.affectHair ? 2u : 0u) |
+                                                     (c.affectArmor ? 4u : 0u) | (c.affectWeapons ? 8u : 0u));
+        c.activityMask = static_cast<std::uint8_t>(c.activityCatMask & 0x0F);
+        c.minSubmerge = std::clamp(c.minSubmergeToSoak, 0.0f, 0.99f);
+        c.heatRadius = std::max(50.0f, c.nearFireRadius);
+        c.heatDryMul = std::max(1.0f, c.dryMultiplierNearFire);
+        c.waterfallRadiusSq = c.nearWaterfallRadius * c.nearWaterfallRadius;
+        c.waterfallMaxDz = std::max(1200.f, c.nearWaterfallRadius * 1.5f);
+        c.waterfallPad[0] = std::max(0.f, c.waterfallWidthPad);
+        c.waterfallPad[1] = std::max(0.f, c.waterfallDepthPad);
+        c.waterfallPad[2] = std::max(0.f, c.waterfallZPad);
+        c.tickIntervalMs = std::max(10, c.updateIntervalMs);
+    }
+
+    // Lock-free and never null.
+    std::shared_ptr<const Config> GetConfig();
+    // Rebuilds the config from the settings. Load and reset publish on their own; the menu calls the
+    // IfChanged variant after drawing, which only republishes when a value differs from the current config.
+    void PublishConfig();
+    void PublishConfigIfChanged();
+
+    // Editable lists. Only touch them through an ActorListsEdit, readers use GetActorListsSnapshot().
     extern std::vector<FormSpec> actorOverrides;
     extern std::vector<FormSpec> trackedActors;
     extern std::shared_mutex actorsMutex;
-    std::vector<FormSpec> SnapshotTrackedActors();
-    std::vector<FormSpec> SnapshotActorOverrides();
+
+    // Immutable copy of both lists, republished whenever they are edited.
+    struct ActorListsSnapshot {
+        std::uint64_t version{0};  // bumped on every edit
+        std::vector<FormSpec> overrides;
+        std::vector<FormSpec> tracked;
+        // Every non-zero ID enabled in either list, plus the ID its plugin resolves to in the current load order,
+        // so opt-in membership of a ref or its base is a plain lookup.
+        std::unordered_set<std::uint32_t> enabledIDs;
+    };
+
+    // Lock-free and never null; holding the pointer keeps that version alive.
+    std::shared_ptr<const ActorListsSnapshot> GetActorListsSnapshot();
+
+    // Exclusive access to the editable lists, the snapshot is republished when the edit goes out of scope.
+    class ActorListsEdit {
+    public:
+        ActorListsEdit();
+        ~ActorListsEdit();
+        ActorListsEdit(const ActorListsEdit&) = delete;
+        ActorListsEdit& operator=(const ActorListsEdit&) = delete;
+
+    private:
+        std::unique_lock<std::shared_mutex> _lk;
+    };
+
+    // Re-resolves the saved FormIDs against the load order; the lists are read before plugins are loaded.
+    void RebaseActorLists();
 
     std::string DefaultPath();
 
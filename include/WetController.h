@@ -3,6 +3,10 @@
 #include <unordered_map>
 
 #include "Settings.h"
+#include "utils/CoSave.h"
+#include "utils/InputRecorder.h"
+#include "utils/SharedTable.h"
+#include "utils/WetSim.h"
 
 #include "RE/Skyrim.h"
 #include "SKSE/SKSE.h"
@@ -43,6 +47,45 @@ namespace SWE {
         bool IsUnderRoof(RE::Actor* a) const;
         bool IsActorInExteriorWet(RE::Actor* a) const;
 
+        // SWE_ENV_* bits as of the last tick that updated the actor, so polling callers cost no raycasts.
+        // Recomputed on the calling thread when there is none yet or it is older than maxAgeSec (<= 0 forces it);
+        // ageSec receives the age of what is returned. Only actors the tick holds live state for cache a mask, the
+        // query never restores saved or cold state. The tick skips the heat probe in water, so the first call that
+        // reads such a mask probes SWE_ENV_NEAR_HEAT alone.
+        static constexpr float kEnvMaskMaxAgeSec = 2.f;
+        std::uint32_t GetEnvMask(RE::Actor* a, float maxAgeSec = kEnvMaskMaxAgeSec, float* ageSec = nullptr);
+
+        // Batch forms of GetFinalWetnessForActor and GetEnvMask, read under one lock. Any out array may be null;
+        // outCat holds 4 values per actor (skin, hair, armor, weapon). Returns how many of the actors have state.
+        std::size_t QueryActors(std::span<RE::Actor* const> actors, float* outWet, float* outCat,
+                                std::uint32_t* outEnv);
+        // Same for every actor currently simulated (unloaded actors kept only for the save are not listed), with
+        // the last cached env mask as is. Fills up to outIDs.size() entries and returns the total count.
+        std::size_t QueryTrackedActors(std::span<std::uint32_t> outIDs, float* outWet, float* outCat,
+                                       std::uint32_t* outEnv);
+
+        // Same layout as SWE::API::WetnessEvent in DynamicWetness_PublicAPI.h
+        struct WetnessEvent {
+            std::uint32_t size{sizeof(WetnessEvent)};
+            std::uint32_t subscription{0};
+            std::uint32_t formID{0};
+            float wetness{0.f};
+            float threshold{0.f};
+            std::uint32_t rising{0};
+            std::uint64_t stateVersion{0};
+        };
+        static constexpr std::uint32_t kMsgWetnessCrossed = 0x53574501;
+        using WetnessCallback = void(__cdecl*)(const WetnessEvent*, void* user);
+
+        // The tick reports an actor's final wetness reaching threshold and falling back below threshold - hysteresis;
+        // formID 0 watches every simulated actor. Events go out on the game thread at the end of the tick, to cb or,
+        // without one, as an SKSE message of type kMsgWetnessCrossed. Returns 0 for an invalid threshold.
+        std::uint32_t Subscribe(std::uint32_t formID, float threshold, float hysteresis, WetnessCallback cb,
+                                void* user);
+        bool Unsubscribe(std::uint32_t id);
+        // Bumped by every tick that changes some actor's final wetness and by every external source edit.
+        std::uint64_t GetStateVersion() const { return _stateVersion.load(std::memory_order_acquire); }
+
         struct OverrideParams {
             float maxGloss{-1.f};
             float maxSpec{-1.f};
@@ -57,6 +100,31 @@ namespace SWE {
         void SetExternalWetnessEx(RE::Actor* a, std::string key, float value, float durationSec, std::uint8_t catMask,
                                   const OverrideParams& ov);
 
+        // Same order and layout as SWE::API::PerfCounters in DynamicWetness_PublicAPI.h
+        enum PerfCounter : std::uint8_t {
+            kPerfTicks,
+            kPerfActorsUpdated,
+            kPerfActorsSkipped,
+            kPerfRaycasts,
+            kPerfRefsScanned,
+            kPerfMaterialsTouched,
+            kPerfSetupGeometry,
+            kPerfMatCacheHits,
+            kPerfMatCacheMisses,
+            kPerfCount
+        };
+        struct PerfCounters {
+            static constexpr std::uint32_t kVersion = 1;
+            std::uint32_t size{sizeof(PerfCounters)};
+            std::uint32_t version{0};
+            std::uint64_t total[kPerfCount]{};
+            double perSecond[kPerfCount]{};  // over the last completed ~1s window
+            std::uint64_t bytesWetData{0};   // approximate heap footprint
+            std::uint64_t bytesMatCache{0};
+            std::uint64_t bytesSources{0};
+        };
+        void GetPerfCounters(PerfCounters& out) const;
+
     private:
         WetController() = default;
         ~WetController() = default;
@@ -69,10 +137,18 @@ namespace SWE {
 
         float _lastGameHours{0.0f};
         double _carrySkipSec{0.0};
+        // Written by the tick only; API threads read them to settle actors on a copy.
+        std::atomic<float> _stepDt{1.f};     // effDt of one regular tick, long intervals are integrated against it
+        std::atomic<double> _simClock{0.0};  // sum of effDt, the time base of WetData::simTime
         bool _hasLastGameHours{false};
 
         void TickGameThread();
         void ScheduleNextTick();
+        void DeserializeV6(SKSE::SerializationInterface* intfc, std::uint32_t length);
+
+        std::chrono::steady_clock::time_point _perfWindowStart{};
+        std::uint64_t _perfWindowBase[kPerfCount]{};
+        void UpdatePerfWindow(std::chrono::steady_clock::time_point now);
 
         struct ExternalSource {
             float value{0.f};             // 0...1
@@ -82,6 +158,72 @@ namespace SWE {
             OverrideParams ov;
         };
 
+        struct MatSnapshot {
+            float baseAlpha{1.f};
+            float baseSpecularPower{20.f};
+            float baseSpecularScale{1.f};
+            float baseSpecR{1.f}, baseSpecG{1.f}, baseSpecB{1.f};
+            bool hadSpecular{false};
+        };
+
+        struct GeomBinding {
+            RE::BSGeometry* geom{nullptr};
+            RE::BSLightingShaderProperty* lsp{nullptr};
+            bool pbr{false};  // material looks PBR (or is a CS TruePBR armor/weapon)
+        };
+
+        // Lighting properties of an actor's 3D, bucketed by material category.
+        // Rebuilt whenever the geometry stamp (equipment / 3D reload) changes.
+        struct GeomIndex {
+            bool valid{false};
+            std::uint32_t stamp{0};
+            const RE::NiAVObject* roots[2]{nullptr, nullptr};
+            std::vector<GeomBinding> byCat[4];  // 0=Skin, 1=Hair, 2=Armor, 3=Weapon
+            std::vector<GeomBinding> eyes;
+        };
+
+        // Snapshot of every setting the material response depends on, compared to detect when profiles are stale.
+        struct ResponseSettings {
+            float maxGloss{0.f}, maxSpec{0.f}, minGloss{0.f}, minSpec{0.f};
+            float glossBoost{0.f}, specBoost{0.f}, skinHairMul{1.f};
+            bool pbrFriendly{false};
+            bool clearcoat{false};
+            float clearcoatMul{1.f};
+            float armorWeapMul{1.f};
+            float pbrMaxGloss{0.f}, pbrMaxSpec{0.f};
+            std::uint8_t catEnabled{0x0F};  // bit per category
+            bool operator==(const ResponseSettings&) const = default;
+        };
+
+        struct ResponseProfile;
+        using WetKernelFn = void (*)(RE::BSGeometry*, RE::BSLightingShaderProperty*, RE::BSLightingShaderMaterialBase*,
+                                     const MatSnapshot&, const ResponseProfile&, float);
+
+        // Per category and material class response with overrides already resolved.
+        struct ResponseProfile {
+            bool enabled{true};
+            float glossGain{0.f}, scaleGain{0.f};  // boost * category multiplier
+            float minGloss{0.f}, maxGloss{0.f}, minSpec{0.f}, maxSpec{0.f};
+            float blend{1.f};  // PBR armor/weapon: fraction of the wet delta that is kept
+            float capGloss{0.f}, capSpec{0.f};
+            bool forceSpecular{false};
+            WetKernelFn kernel{nullptr};
+        };
+
+        // What the actor lists say about one actor, resolved once per list version and actor base.
+        struct ActorPolicy {
+            bool valid{false};
+            std::uint64_t listsVersion{0};
+            std::uint32_t baseID{0};
+            bool listed{false};  // in the opt-in allow set
+            bool autoWet{true};  // tracked as Automatic (default) or Manual
+            bool hasOverride{false};
+            float forcedWet{0.f};
+            std::uint8_t forcedMask{0x0F};
+        };
+
+        using EnvClass = Sim::EnvClass;
+
         struct WetData {
             float wetness{0.f};  // 0...1
             float lastAppliedWet{-1.f};
@@ -91,6 +233,9 @@ namespace SWE {
             bool lastRoofCovered{false};
             std::chrono::steady_clock::time_point lastHeatProbe{};
             bool cachedNearHeat{false};
+            std::uint8_t envMask{0};  // see GetEnvMask
+            bool envHeatLazy{false};  // envMask was taken in water without a heat probe, GetEnvMask adds it
+            std::chrono::steady_clock::time_point envMaskAt{};
             std::unordered_map<std::string, ExternalSource> extSources;
             std::chrono::steady_clock::time_point lastWaterfallProbe{};
             bool cachedInsideWaterfall{false};
@@ -99,6 +244,7 @@ namespace SWE {
                 bool any{false};
                 float maxGloss{-1.f}, maxSpec{-1.f}, minGloss{-1.f}, minSpec{-1.f};
                 float glossBoost{-1.f}, specBoost{-1.f}, skinHairMul{-1.f};
+                bool operator==(const CatOverrides&) const = default;
             };
             CatOverrides activeOv[4]{};  // 0=Skin, 1=Hair, 2=Armor, 3=Weapon
             float lastAppliedCat[4]{-1.f, -1.f, -1.f, -1.f};
@@ -108,15 +254,126 @@ namespace SWE {
 
             std::uint32_t lastGeomStamp{0};
             std::chrono::steady_clock::time_point lastGeomProbe{};
+
+            GeomIndex geomIndex;
+
+            struct ProfileKey {
+                bool valid{false};
+                ResponseSettings settings{};
+                CatOverrides ov[4]{};
+            };
+            ProfileKey profileKey;
+            ResponseProfile profiles[4][2]{};  // [category][0=classic, 1=PBR]
+
+            ActorPolicy policy;
+
+            double simTime{-1.0};  // _simClock at the last update, -1 = not simulated yet
+            EnvClass envClass{EnvClass::kDrying};
+            std::uint32_t recSession{0};  // Rec::Session() the state was last captured in
         };
 
         std::unordered_map<uint32_t, WetData> _wet;
 
+        // Actors restored from the co-save stay in decoded form (sorted by resolved FormID) until the tick or the
+        // API first touches them, so loading does not build state for every NPC the save has ever seen.
+        // An entry is consumed once it has been materialized: from then on the actor's state lives in _wet or _cold
+        // (or is gone because it dried off), and the saved copy must neither come back on a lookup nor be saved again.
+        CoSave::Image _pending;
+        std::vector<bool> _pendingUsed;  // parallel to _pending.actors
+        std::size_t _pendingLeft{0};     // entries not consumed yet
+
+        void AdoptPending(CoSave::Image&& img);
+        const CoSave::Actor* FindPending(std::uint32_t id) const;  // skips consumed entries
+        WetData& Materialize(const CoSave::Actor& saved);           // consumes saved
+        // Actors that went unseen while still wet leave _wet for this compact tier and come back on their next
+        // lookup. Sorted by FormID.
+        struct ColdActor {
+            std::uint32_t formID{0};
+            std::uint8_t cat[4]{0, 0, 0, 0};  // simulated wetness per category in 1/255 steps
+            std::uint32_t lastSeenSec{0};     // steady clock seconds, for eviction
+            std::uint32_t simSec : 30 {0};    // _simClock seconds when it was last simulated
+            std::uint32_t env : 2 {0};        // EnvClass
+        };
+        static_assert(sizeof(ColdActor) == 16);
+        std::vector<ColdActor> _cold;
+        std::chrono::steady_clock::time_point _lastTierPass{};
+
+        // Moves idle actors to the cold tier and evicts cold ones by age and count, every couple of seconds.
+        void UpdateTiers(std::chrono::steady_clock::time_point now);
+        const ColdActor* FindCold(std::uint32_t id) const;
+        WetData* Thaw(std::uint32_t id);
+
+        // _wet lookups that pull in the actor's saved or cold state first; WetOf creates the entry when there is none.
+        WetData* FindWet(std::uint32_t id);
+        WetData& WetOf(std::uint32_t id);
+
+        // Material applies are deferred and drained at the end of each tick under a geometry budget,
+        // so many actors changing at once (rain start, save load) converge over a few ticks.
+        struct PendingApply {
+            RE::ActorHandle handle;
+            float wetByCat[4]{0.f, 0.f, 0.f, 0.f};
+            std::uint8_t catMask{0};
+            bool deferred{false};  // held back while the actor was off-screen
+        };
+        std::unordered_map<std::uint32_t, PendingApply> _applyQueue;
+
+        // The player's "1st Person" node, re-resolved only when the 3rd person root changes or it got detached
+        struct FirstPersonCache {
+            const RE::NiAVObject* third{nullptr};
+            RE::NiPointer<RE::NiAVObject> first;
+            std::chrono::steady_clock::time_point lastSearch{};
+        };
+        FirstPersonCache _fpCache;
+        bool _lastFirstPerson{false};
+
+        RE::NiAVObject* GetFirstPersonRoot(RE::NiAVObject* third);
+        // Roots that are currently rendered: [0] 3rd person, [1] the player's 1st person node in first person.
+        void ResolveRenderRoots(RE::Actor* a, RE::NiAVObject* out[2]);
+
+        void QueueApply(RE::Actor* a, const float wetByCat[4], std::uint8_t catMask = 0x0F);
+        void DrainApplyQueue();
+
         std::chrono::steady_clock::time_point _lastTick = std::chrono::steady_clock::now();
+        // Settings as of the current tick, everything below TickGameThread reads from this
+        std::shared_ptr<const Settings::Config> _cfg = Settings::GetConfig();
 
-        void UpdateActorWetness(RE::Actor* a, float dt, const std::vector<Settings::FormSpec>& overrides,
+        // World state shared by every actor update, read once at the start of the tick.
+        struct WorldContext {
+            std::chrono::steady_clock::time_point now{};
+            float gameHours{0.f};
+            bool paused{false};        // game paused or main menu open
+            bool rain{false};          // raining and rain enabled
+            bool snow{false};          // snowing and snow enabled
+            bool craftingMenu{false};  // crafting, alchemy, enchanting or cooking menu open (only with that trigger on)
+        };
+        WorldContext _world;
+        void BuildWorldContext(const Settings::Config& cfg);
+
+        void UpdateActorWetness(RE::Actor* a, float dt, const Settings::ActorListsSnapshot& lists,
                                 bool allowEnvWet = true, bool manualMode = false);
-        void ApplyWetnessMaterials(RE::Actor* a, const float wetByCat[4]);
+
+        static ActorPolicy ResolvePolicy(RE::Actor* a, const Settings::ActorListsSnapshot& lists);
+        // The cached policy, re-resolved when the lists were edited or the actor's base changed.
+        static const ActorPolicy& PolicyFor(WetData& wd, RE::Actor* a, const Settings::ActorListsSnapshot& lists);
+        // Policy of an actor that has no state. In opt-in mode most high-process NPCs match no list and never get
+        // state, so those are remembered by FormID (with the base they were resolved for) until the lists change.
+        ActorPolicy PolicyForUnknown(RE::Actor* a, const Settings::ActorListsSnapshot& lists);
+        std::unordered_map<std::uint32_t, std::uint32_t> _unlisted;  // FormID -> base FormID; tick thread only
+        std::uint64_t _unlistedVersion{0};
+        // catMask selects which categories are (re)applied, the full set is forced when the geometry index is rebuilt.
+        // Returns the categories that were actually applied.
+        std::uint8_t ApplyWetnessMaterials(RE::Actor* a, const float wetByCat[4], std::uint8_t catMask = 0x0F);
+        void RebuildGeomIndex(GeomIndex& idx, RE::NiAVObject* const roots[2], std::uint32_t stamp);
+
+        static ResponseSettings LoadResponseSettings(const Settings::Config& cfg);
+        static void CompileResponseProfiles(const ResponseSettings& s, const WetData::CatOverrides ov[4],
+                                            ResponseProfile out[4][2]);
+        static void RestoreMaterial(RE::BSGeometry* g, RE::BSLightingShaderProperty* lsp,
+                                    RE::BSLightingShaderMaterialBase* mat, const MatSnapshot& base);
+        template <bool kPbr, bool kArmorBlend>
+        static void WetKernel(RE::BSGeometry* g, RE::BSLightingShaderProperty* lsp,
+                              RE::BSLightingShaderMaterialBase* mat, const MatSnapshot& base,
+                              const ResponseProfile& p, float wet);
 
         bool IsRainingCurrent() const;
         bool IsSnowingCurrent() const;
@@ -125,20 +382,67 @@ namespace SWE {
 
         bool RayHitsCover(const RE::NiPoint3& from, const RE::NiPoint3& to,
                           const RE::TESObjectREFR* ignoreRef = nullptr) const;
+        // The roof rays of IsUnderRoof, for callers that already know it is precipitating.
+        bool RoofCovers(RE::Actor* a) const;
+        // Full synchronous probe behind GetEnvMask.
+        std::uint8_t ComputeEnvMask(RE::Actor* a) const;
+        // An actor's current wetness and categories for the API, changing nothing: live state is settled up to the
+        // sim clock on a copy, saved and cold state is read where it lies. Call under _mtx; false without state.
+        bool PeekState(std::uint32_t id, float& outWet, float outCat[4]) const;
+        float SettledState(const WetData& wd, const Settings::Config& cfg, double until, float outCat[4]) const;
+        // Writes entry i of the QueryActors arrays.
+        static void PutState(std::size_t i, float wet, const float cat[4], float* outWet, float* outCat);
+
+        struct Subscription {
+            std::uint32_t id{0};
+            std::uint32_t formID{0};  // 0 = every actor
+            float threshold{0.f};
+            float hysteresis{0.f};
+            WetnessCallback cb{nullptr};  // null = SKSE message
+            void* user{nullptr};
+            std::atomic<bool> active{true};
+            std::unordered_set<std::uint32_t> above;  // actors at or over the threshold, tick thread only
+        };
+        using SubscriptionList = std::vector<std::shared_ptr<Subscription>>;
+        struct PendingEvent {
+            std::shared_ptr<Subscription> sub;
+            WetnessEvent ev;
+            RE::Actor* actor{nullptr};  // only valid until the end of the tick that queued it
+        };
+        // Published copy-on-write like the settings, so the tick reads it without a lock.
+        std::atomic<std::shared_ptr<const SubscriptionList>> _subs{std::make_shared<const SubscriptionList>()};
+        std::mutex _subMtx;  // serializes Subscribe/Unsubscribe
+        std::uint32_t _nextSubID{1};
+        // Papyrus has no natives for this; its ModEvent is driven by the modEvent* settings instead.
+        std::shared_ptr<Subscription> _modEventSub{std::make_shared<Subscription>()};
+        std::vector<PendingEvent> _events;
+        std::atomic<std::uint64_t> _stateVersion{1};
+        bool _stateDirty{false};
+
+        // Called with every final wetness the tick computes; queues threshold crossings.
+        void NoteWetness(RE::Actor* a, float before, float after);
+        void CheckCrossing(const std::shared_ptr<Subscription>& s, RE::Actor* a, float wet);
+        void DispatchWetnessEvents();
+
+        // Mirrors the simulated actors into the shared-memory table while sharedTableEnabled is on.
+        void PublishSharedTable();
+        std::vector<Shared::Entry> _sharedRows;
+        bool _sharedTableFailed{false};  // warned once, retried after the setting is toggled
 
-        void ComputeWetByCategory(WetData& wd, float baseWet, float outWetByCat[4], float dt, bool envDominates,
-                                  float dryMul);
+        // Folds the overrides of the live sources into activeOv; the environment clears them.
+        static void UpdateActiveOverrides(WetData& wd, bool envDominates);
+        // Brings an actor that was not updated since wd.simTime up to until, assuming it stayed in wd.envClass.
+        // Tick thread only, API reads go through SettledState.
+        void Settle(WetData& wd, double until);
+        // Captures the state of an actor the current recording has not seen yet, so a replay can start from it.
+        void RecordState(std::uint32_t formID, WetData& wd, double clock);
+        // Records a source as the API just stored it; called under _mtx so it lands in the order it was applied.
+        static void RecordSource(Rec::ExtOp op, std::uint32_t formID, const std::string& key,
+                                 const ExternalSource& src);
         float GetGameHours() const;
 
         mutable std::recursive_mutex _mtx;
 
-        struct MatSnapshot {
-            float baseAlpha{1.f};
-            float baseSpecularPower{20.f};
-            float baseSpecularScale{1.f};
-            float baseSpecR{1.f}, baseSpecG{1.f}, baseSpecB{1.f};
-            bool hadSpecular{false};
-        };
         std::unordered_map<const RE::BSLightingShaderProperty*, MatSnapshot> _matCache;
         friend class DebugAccess;
     };
@@ -106,6 +106,58 @@ namespace SWE {
             return e;
         }
 
+        // ===========================
+        // Performance counters
+        // ===========================
+        /**
+         * @brief Indices into PerfCounters::total / PerfCounters::perSecond.
+         */
+        static constexpr std::uint32_t PERF_TICKS = 0;              /// Simulation ticks run.
+        static constexpr std::uint32_t PERF_ACTORS_UPDATED = 1;     /// Actors simulated (player included).
+        static constexpr std::uint32_t PERF_ACTORS_SKIPPED = 2;     /// Loaded NPCs skipped (radius / opt-in).
+        static constexpr std::uint32_t PERF_RAYCASTS = 3;           /// Havok ray casts (roof probes).
+        static constexpr std::uint32_t PERF_REFS_SCANNED = 4;       /// References visited by heat/waterfall scans.
+        static constexpr std::uint32_t PERF_MATERIALS_TOUCHED = 5;  /// Lighting properties written.
+        static constexpr std::uint32_t PERF_SETUP_GEOMETRY = 6;     /// SetupGeometry calls.
+        static constexpr std::uint32_t PERF_MATCACHE_HITS = 7;      /// Material snapshot cache hits.
+        static constexpr std::uint32_t PERF_MATCACHE_MISSES = 8;    /// Material snapshot cache misses.
+        static constexpr std::uint32_t PERF_COUNT = 9;
+
+        /**
+         * @brief Snapshot filled by GetPerfCounters().
+         *
+         * Set @c size to sizeof(PerfCounters) before the call (the constructor does); SWE never writes past it,
+         * so structs from older headers stay valid when fields are appended.
+         */
+        struct PerfCounters {
+            std::uint32_t size{sizeof(PerfCounters)};
+            std::uint32_t version{0};               /// Layout version reported by SWE (currently 1).
+            std::uint64_t total[PERF_COUNT]{};      /// Cumulative since the game was started.
+            double perSecond[PERF_COUNT]{};         /// Rate over the last completed ~1s window.
+            std::uint64_t bytesWetData{0};          /// Approximate heap use of the per-actor state.
+            std::uint64_t bytesMatCache{0};         /// Approximate heap use of the material snapshot cache.
+            std::uint64_t bytesSources{0};          /// Approximate heap use of external source maps.
+        };
+
+        /**
+         * @brief Threshold crossing reported to a SubscribeWetness() subscriber.
+         *
+         * Delivered on the game thread at the end of SWE's update, either to your callback or, when you passed
+         * none, as an SKSE message of type MSG_WETNESS_CROSSED (sender "DynamicWetness", data = this struct):
+         *   SKSE::GetMessagingInterface()->RegisterListener("DynamicWetness", OnSWEMessage);
+         */
+        struct WetnessEvent {
+            std::uint32_t size{sizeof(WetnessEvent)};
+            std::uint32_t subscription{0};  /// Id returned by SubscribeWetness().
+            std::uint32_t formID{0};        /// Actor whose wetness crossed.
+            float wetness{0.f};             /// Final wetness after the crossing [0..1].
+            float threshold{0.f};
+            std::uint32_t rising{0};        /// 1 = reached the threshold, 0 = fell below threshold - hysteresis.
+            std::uint64_t stateVersion{0};  /// GetStateVersion() at delivery.
+        };
+        static constexpr std::uint32_t MSG_WETNESS_CROSSED = 0x53574501;
+        using WetnessCallback = void(__cdecl*)(const WetnessEvent*, void* user);
+
         // ===========================
         // C-ABI function signatures
         // ===========================
@@ -126,6 +178,13 @@ namespace SWE {
         using PFN_IsUnderRoof = bool(__cdecl*)(RE::Actor*);
         using PFN_IsActorInExteriorWet = bool(__cdecl*)(RE::Actor*);
         using PFN_GetEnvMask = unsigned(__cdecl*)(RE::Actor*);
+        using PFN_GetEnvMaskEx = unsigned(__cdecl*)(RE::Actor*, float, float*);
+        using PFN_GetActorStates = unsigned(__cdecl*)(RE::Actor* const*, unsigned, float*, float*, unsigned*);
+        using PFN_GetTrackedActorStates = unsigned(__cdecl*)(unsigned*, unsigned, float*, float*, unsigned*);
+        using PFN_SubscribeWetness = unsigned(__cdecl*)(unsigned, float, float, WetnessCallback, void*);
+        using PFN_UnsubscribeWetness = bool(__cdecl*)(unsigned);
+        using PFN_GetStateVersion = std::uint64_t(__cdecl*)();
+        using PFN_GetPerfCounters = bool(__cdecl*)(PerfCounters*);
 
         // Resolved at runtime by Init()/LoadFromModule()
         inline PFN_GetFinalWetness pGetFinalWetness = nullptr;
@@ -142,6 +201,13 @@ namespace SWE {
         inline PFN_IsUnderRoof pIsUnderRoof = nullptr;
         inline PFN_IsActorInExteriorWet pIsActorInExteriorWet = nullptr;
         inline PFN_GetEnvMask pGetEnvMask = nullptr;
+        inline PFN_GetEnvMaskEx pGetEnvMaskEx = nullptr;
+        inline PFN_GetActorStates pGetActorStates = nullptr;
+        inline PFN_GetTrackedActorStates pGetTrackedActorStates = nullptr;
+        inline PFN_SubscribeWetness pSubscribeWetness = nullptr;
+        inline PFN_UnsubscribeWetness pUnsubscribeWetness = nullptr;
+        inline PFN_GetStateVersion pGetStateVersion = nullptr;
+        inline PFN_GetPerfCounters pGetPerfCounters = nullptr;
 
         // ===========================
         // Loader helpers
@@ -169,6 +235,14 @@ namespace SWE {
             pIsUnderRoof = (PFN_IsUnderRoof)gp("SWE_IsUnderRoof");
             pIsActorInExteriorWet = (PFN_IsActorInExteriorWet)gp("SWE_IsActorInExteriorWet");
             pGetEnvMask = (PFN_GetEnvMask)gp("SWE_GetEnvMask");
+            // optional, newer builds only
+            pGetEnvMaskEx = (PFN_GetEnvMaskEx)gp("SWE_GetEnvMaskEx");
+            pGetActorStates = (PFN_GetActorStates)gp("SWE_GetActorStates");
+            pGetTrackedActorStates = (PFN_GetTrackedActorStates)gp("SWE_GetTrackedActorStates");
+            pSubscribeWetness = (PFN_SubscribeWetness)gp("SWE_SubscribeWetness");
+            pUnsubscribeWetness = (PFN_UnsubscribeWetness)gp("SWE_UnsubscribeWetness");
+            pGetStateVersion = (PFN_GetStateVersion)gp("SWE_GetStateVersion");
+            pGetPerfCounters = (PFN_GetPerfCounters)gp("SWE_GetPerfCounters");
 
             return pGetFinalWetness && pSetExternalWetness && pSetExternalWetnessMask && pGetEnvMask;
 #else
@@ -331,9 +405,90 @@ namespace SWE {
 
         /**
          * @brief Raw environment mask (see ENV_*). Prefer DecodeEnv() for convenience.
+         * @note Served from SWE's last update of the actor when that is at most ~2s old, so polling is cheap.
          */
         inline unsigned GetEnvMask(RE::Actor* a) { return pGetEnvMask ? pGetEnvMask(a) : 0u; }
 
+        /**
+         * @brief Environment mask with control over how old a cached result may be.
+         * @param maxAgeSec Oldest acceptable cached mask in seconds; <= 0 forces a fresh probe (raycasts, cell scan).
+         * @param ageSec    Optional, receives the age of the returned mask (0 when it was just probed).
+         * @note Falls back to GetEnvMask() on older SWE builds, reporting an age of 0.
+         */
+        inline unsigned GetEnvMaskEx(RE::Actor* a, float maxAgeSec, float* ageSec = nullptr) {
+            if (pGetEnvMaskEx) return pGetEnvMaskEx(a, maxAgeSec, ageSec);
+            if (ageSec) *ageSec = 0.f;
+            return GetEnvMask(a);
+        }
+        /// @brief Probe the environment now instead of using the cached mask.
+        inline unsigned RefreshEnvMask(RE::Actor* a) { return GetEnvMaskEx(a, 0.f); }
+
+        /**
+         * @brief Final wetness, per-category wetness and env mask of many actors in one call.
+         * @param actors        Array of @p count actors (null entries read as dry).
+         * @param outWetness    Optional, @p count floats as from GetFinalWetness().
+         * @param outCatWetness Optional, 4 * @p count floats: skin, hair, armor, weapon per actor.
+         * @param outEnvMask    Optional, @p count masks as from GetEnvMask().
+         * @return How many of the actors SWE has state for.
+         * @note On older SWE builds this falls back to one call per actor, reports per-category values as 0
+         *       and counts every non-null actor.
+         */
+        inline unsigned GetActorStates(RE::Actor* const* actors, unsigned count, float* outWetness,
+                                       float* outCatWetness = nullptr, unsigned* outEnvMask = nullptr) {
+            if (pGetActorStates) return pGetActorStates(actors, count, outWetness, outCatWetness, outEnvMask);
+            unsigned n = 0;
+            for (unsigned i = 0; actors && i < count; ++i) {
+                if (actors[i]) ++n;
+                if (outWetness) outWetness[i] = actors[i] ? GetFinalWetness(actors[i]) : 0.f;
+                if (outCatWetness)
+                    for (unsigned c = 0; c < 4; ++c) outCatWetness[4 * i + c] = 0.f;
+                if (outEnvMask) outEnvMask[i] = actors[i] ? GetEnvMask(actors[i]) : 0u;
+            }
+            return n;
+        }
+
+        /**
+         * @brief Same as GetActorStates() for every actor SWE currently simulates, identified by FormID.
+         * @param capacity Size of the arrays; at most this many entries are written.
+         * @return Total number of simulated actors (call again with a larger buffer if it exceeds @p capacity),
+         *         0 if SWE is not available or too old.
+         * @note Env masks are the last cached ones, without a refresh (the actors may be unloaded).
+         */
+        inline unsigned GetTrackedActorStates(unsigned* outFormIDs, unsigned capacity, float* outWetness,
+                                              float* outCatWetness = nullptr, unsigned* outEnvMask = nullptr) {
+            return pGetTrackedActorStates
+                       ? pGetTrackedActorStates(outFormIDs, capacity, outWetness, outCatWetness, outEnvMask)
+                       : 0u;
+        }
+
+        /**
+         * @brief Get told when an actor's final wetness crosses a threshold instead of polling GetFinalWetness().
+         * @param formID     Actor to watch, 0 = every actor SWE simulates.
+         * @param threshold  (0..1]; a rising event fires when wetness reaches it.
+         * @param hysteresis The falling event fires once wetness drops below threshold - hysteresis.
+         * @param cb         Called on the game thread; nullptr = SKSE message MSG_WETNESS_CROSSED instead.
+         * @return Subscription id for UnsubscribeWetness(), 0 on failure or on older SWE builds.
+         * @note An actor that is already past the threshold when first seen gets a rising event.
+         */
+        inline unsigned SubscribeWetness(unsigned formID, float threshold, float hysteresis, WetnessCallback cb,
+                                         void* user = nullptr) {
+            return pSubscribeWetness ? pSubscribeWetness(formID, threshold, hysteresis, cb, user) : 0u;
+        }
+        /// @brief Stop a subscription; events still queued for it are not delivered.
+        inline bool UnsubscribeWetness(unsigned id) { return pUnsubscribeWetness ? pUnsubscribeWetness(id) : false; }
+        /**
+         * @brief Counter that grows whenever any actor's wetness or external sources change.
+         * Compare with the value you last saw to skip work when nothing changed. 0 if unavailable.
+         */
+        inline std::uint64_t GetStateVersion() { return pGetStateVersion ? pGetStateVersion() : 0u; }
+
+        /**
+         * @brief Read SWE's performance counters (see PERF_*).
+         * @param out Receives the counters; keep @c out.size as constructed.
+         * @return false if SWE is not available or too old to export counters.
+         */
+        inline bool GetPerfCounters(PerfCounters& out) { return pGetPerfCounters ? pGetPerfCounters(&out) : false; }
+
         /**
          * @brief Helper to build a category mask (no flags).
          */
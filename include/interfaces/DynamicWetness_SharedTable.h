@@ -0,0 +1,185 @@
+// Read-only shared-memory table of DynamicWetness actor state, for tools running in another process
+// (overlays, telemetry). Header-only; reading needs no calls into the game or into SWE.
+//
+// Quick start:
+//   #include "DynamicWetness_SharedTable.h"
+//   SWE::Shared::Reader table;
+//   std::vector<SWE::Shared::Entry> rows;
+//   if (table.Open() && table.Snapshot(rows)) { ... }   // Open() fails until SWE has created the table
+//
+// Notes:
+//  - SWE only publishes while "Publish shared-memory table" is enabled in its menu (Integration).
+//  - Layout: Header, then Header::capacity rows of Header::entryStride bytes; rows [0, count) are valid and
+//    sorted by FormID. Newer versions may append fields to Entry, so always step by entryStride.
+//  - The writer updates the whole table under a seqlock (Header::seq is odd while it writes); Snapshot() retries
+//    until it copied a consistent view.
+//  - Timestamps are milliseconds of std::chrono::steady_clock (QueryPerformanceCounter on Windows,
+//    CLOCK_MONOTONIC elsewhere), comparable across processes on the same machine; see NowMs().
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace SWE::Shared {
+
+#ifdef _WIN32
+    inline constexpr const char* kMappingName = "Local\\DynamicWetness.ActorTable";
+#else
+    inline constexpr const char* kMappingName = "/DynamicWetness.ActorTable";
+#endif
+    inline constexpr std::uint32_t kMagic = 0x54415753;  // "SWAT"
+    inline constexpr std::uint32_t kVersion = 1;
+
+    /// One actor, as of SWE's last update.
+    struct Entry {
+        std::uint32_t formID{0};
+        std::uint32_t envMask{0};     /// ENV_* bits, see GetEnvMask() in DynamicWetness_PublicAPI.h.
+        float wetness{0.f};           /// Final wetness [0..1].
+        float cat[4]{};               /// Per category: skin, hair, armor, weapon.
+        std::uint32_t reserved{0};
+        std::uint64_t lastSeenMs{0};  /// When SWE last saw the actor loaded.
+        std::uint64_t envMs{0};       /// When envMask was probed, 0 = never.
+    };
+    static_assert(sizeof(Entry) == 48);
+
+    struct Header {
+        std::uint32_t magic{0};
+        std::uint32_t version{0};
+        std::uint32_t headerSize{0};        /// Offset of the first row.
+        std::uint32_t entryStride{0};       /// Bytes per row.
+        std::uint32_t capacity{0};          /// Rows the mapping has room for.
+        std::uint32_t writerPid{0};
+        std::atomic<std::uint32_t> seq{0};  /// Odd while the writer is inside an update.
+        std::uint32_t count{0};             /// Valid rows.
+        std::uint64_t publishedMs{0};       /// Time of the last update; stops moving while the game is paused.
+        std::uint64_t stateVersion{0};      /// SWE_GetStateVersion() at the last update.
+        std::uint8_t reserved[16]{};
+    };
+    static_assert(sizeof(Header) == 64);
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+    inline std::uint64_t ToMs(std::chrono::steady_clock::time_point t) {
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::milliseconds>(t.time_since_epoch()).count());
+    }
+    inline std::uint64_t NowMs() { return ToMs(std::chrono::steady_clock::now()); }
+
+    /// Read-only view of the table.
+    class Reader {
+    public:
+        Reader() = default;
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        ~Reader() { Close(); }
+
+        /// @return false while the table does not exist or has a layout this header does not know.
+        bool Open() {
+            Close();
+#ifdef _WIN32
+            _map = OpenFileMappingA(FILE_MAP_READ, FALSE, kMappingName);
+            if (!_map) return false;
+            void* p = MapViewOfFile(_map, FILE_MAP_READ, 0, 0, 0);
+            MEMORY_BASIC_INFORMATION mbi{};
+            if (!p || !VirtualQuery(p, &mbi, sizeof(mbi))) {
+                if (p) UnmapViewOfFile(p);
+                Close();
+                return false;
+            }
+            _base = static_cast<const std::uint8_t*>(p);
+            _size = mbi.RegionSize;
+#else
+            const int fd = shm_open(kMappingName, O_RDONLY, 0);
+            if (fd < 0) return false;
+            struct stat st {};
+            void* p = MAP_FAILED;
+            if (fstat(fd, &st) == 0 && st.st_size > 0)
+                p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (p == MAP_FAILED) return false;
+            _base = static_cast<const std::uint8_t*>(p);
+            _size = static_cast<std::size_t>(st.st_size);
+#endif
+            if (!Valid()) {
+                Close();
+                return false;
+            }
+            return true;
+        }
+
+        void Close() {
+#ifdef _WIN32
+            if (_base) UnmapViewOfFile(_base);
+            if (_map) CloseHandle(_map);
+            _map = nullptr;
+#else
+            if (_base) munmap(const_cast<std::uint8_t*>(_base), _size);
+#endif
+            _base = nullptr;
+            _size = 0;
+        }
+
+        bool IsOpen() const { return _base != nullptr; }
+        const Header* GetHeader() const { return reinterpret_cast<const Header*>(_base); }
+
+        /**
+         * @brief Copy a consistent view of the valid rows.
+         * @param publishedMs  Optional, receives Header::publishedMs of the copied view.
+         * @param stateVersion Optional, receives Header::stateVersion of the copied view.
+         * @return false if the table is not open or the writer stayed busy through all @p tries.
+         */
+        bool Snapshot(std::vector<Entry>& rows, std::uint64_t* publishedMs = nullptr,
+                      std::uint64_t* stateVersion = nullptr, int tries = 100) const {
+            const Header* h = GetHeader();
+            if (!h) return false;
+            const std::size_t stride = h->entryStride;
+            const std::size_t copy = stride < sizeof(Entry) ? stride : sizeof(Entry);
+
+            for (int i = 0; i < tries; ++i) {
+                const std::uint32_t s1 = h->seq.load(std::memory_order_acquire);
+                if (s1 & 1u) continue;
+
+                std::uint32_t n = h->count;
+                if (n > h->capacity) n = h->capacity;
+                rows.resize(n);
+                const std::uint8_t* src = _base + h->headerSize;
+                for (std::uint32_t r = 0; r < n; ++r) std::memcpy(&rows[r], src + r * stride, copy);
+                const std::uint64_t pub = h->publishedMs;
+                const std::uint64_t ver = h->stateVersion;
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (h->seq.load(std::memory_order_relaxed) != s1) continue;
+                if (publishedMs) *publishedMs = pub;
+                if (stateVersion) *stateVersion = ver;
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        bool Valid() const {
+            if (_size < sizeof(Header)) return false;
+            const Header* h = GetHeader();
+            if (h->magic != kMagic || h->version != kVersion || h->headerSize < sizeof(Header)) return false;
+            if (h->entryStride == 0) return false;
+            return h->headerSize + static_cast<std::size_t>(h->capacity) * h->entryStride <= _size;
+        }
+
+        const std::uint8_t* _base{nullptr};
+        std::size_t _size{0};
+#ifdef _WIN32
+        HANDLE _map{nullptr};
+#endif
+    };
+}
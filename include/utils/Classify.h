@@ -0,0 +1,60 @@
+#pragma once
+
+// The name and texture-path heuristics that sort geometry into material categories and spot heat sources and work
+// furniture, on plain strings so they can be tested and benchmarked without the game. WetController hands them the
+// node names, texture paths and editor IDs it reads from the scene graph and the forms.
+//
+// Names are matched case-insensitively (ASCII). Nothing here allocates for paths up to NormPath::kInline chars.
+namespace SWE::Classify {
+
+    enum class MatCat { SkinFace, Hair, ArmorClothing, Weapon, Other };
+
+    bool ContainsCI(std::string_view hay, std::string_view needle);
+
+    // A texture path lowercased, with '\' as '/' and runs of '/' collapsed, the form the path checks expect.
+    class NormPath {
+    public:
+        static constexpr std::size_t kInline = 512;
+
+        explicit NormPath(std::string_view path);
+        NormPath(const NormPath&) = delete;
+        NormPath& operator=(const NormPath&) = delete;
+
+        std::string_view view() const { return _view; }
+
+    private:
+        char _inline[kInline];
+        std::string _spill;  // longer paths only
+        std::string_view _view;
+    };
+
+    // On normalized paths: PBR-only folders and suffixes (_orm, _rmaos, ...) and roughness/metal words.
+    bool StrongPBRSignal(std::string_view normPath);
+    // A lone _p suffix is parallax height in vanilla-style sets and ORM in some PBR ones, so it never counts alone.
+    bool HasAmbiguousPSuffix(std::string_view normPath);
+    // Any of paths (raw, may be null) carries a strong PBR signal.
+    bool TexturesLookPBR(std::span<const char* const> paths);
+
+    // A character body/hands/feet texture that is not in an armor or clothes folder.
+    bool BodySkinTextures(const char* diffuse, const char* normal);
+    // One node name that reads as body/hands/feet skin and not as armor.
+    bool BodySkinName(std::string_view name);
+
+    bool HeatSourceName(std::string_view name);
+    bool WorkFurnitureEditorID(std::string_view editorID);
+
+    // What ClassifyGeom reads from a geometry, its material and its skin instance.
+    struct Geom {
+        bool faceGen{false};                    // FaceGen / FaceGenRGBTint material
+        bool hairTint{false};                   // HairTint material
+        std::span<const std::uint16_t> slots;  // biped slots of the dismember partitions, in order
+        const char* diffuse{nullptr};
+        const char* normal{nullptr};
+        // The geometry's name, then its parents' nearest first. The name walk goes 4 levels up and the body-skin
+        // check another 4 from each of those, so up to 7 are read.
+        std::span<const std::string_view> names;
+    };
+    inline constexpr std::size_t kGeomNames = 7;
+
+    MatCat ClassifyGeom(const Geom& g);
+}
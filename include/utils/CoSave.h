@@ -0,0 +1,77 @@
+#pragma once
+
+// Co-save record v6: the whole record is encoded into one buffer and written with a single WriteRecordData.
+// Does not depend on the game, so the codec can be exercised on its own.
+//
+// Layout (little endian):
+//   u32 magic 'SWET'
+//   var keyCount, then per key: var len, bytes         source keys shared by every actor
+//   var actorCount, then per actor (sorted by FormID):
+//     var formID delta, f32 wetness, f32 lastAppliedWet, var sourceCount
+//     per source: var key index, f32 value, f32 remainSec, u8 catMask, var flags,
+//                 u8 override mask (bit i = ov[i] stored), f32 per stored override
+//   u32 FNV-1a of everything before it
+// "var" is an unsigned LEB128 varint.
+namespace SWE::CoSave {
+
+    inline constexpr std::uint32_t kMagic = 'SWET';
+    inline constexpr std::size_t kOverrideCount = 7;  // OverrideParams order
+    inline constexpr float kOverrideUnset = -1.f;
+
+    struct Source {
+        std::uint32_t key{0};  // index into Image::keys
+        float value{0.f};
+        float remainSec{-1.f};
+        std::uint8_t catMask{0x0F};
+        std::uint32_t flags{0};
+        float ov[kOverrideCount]{kOverrideUnset, kOverrideUnset, kOverrideUnset, kOverrideUnset,
+                                 kOverrideUnset, kOverrideUnset, kOverrideUnset};
+    };
+
+    struct Actor {
+        std::uint32_t formID{0};
+        float wetness{0.f};
+        float lastAppliedWet{-1.f};
+        std::uint32_t firstSource{0};  // range in Image::sources
+        std::uint32_t sourceCount{0};
+    };
+
+    // Flat form of the record, sources of one actor are contiguous.
+    struct Image {
+        std::vector<std::string> keys;
+        std::vector<Actor> actors;
+        std::vector<Source> sources;
+
+        void clear() {
+            keys.clear();
+            actors.clear();
+            sources.clear();
+        }
+    };
+
+    // Save-time limits; entries that would not change anything after a load are dropped before the caps apply.
+    struct CompactLimits {
+        std::uint32_t maxActors{0};           // 0 = unlimited
+        std::uint32_t maxSourcesPerActor{0};  // 0 = unlimited, otherwise the strongest are kept
+        float minRemainSec{1.f};              // timed sources closer than this to expiring are dropped
+        float minValue{0.0005f};              // sources and actors at or below this count as dry
+        std::uint32_t keepFlags{0};           // sources with any of these flags are kept even when dry
+    };
+
+    struct CompactStats {
+        std::uint32_t actorsDropped{0};
+        std::uint32_t sourcesDropped{0};
+        std::size_t bytesSaved{0};
+    };
+
+    // Drops expiring and dry entries, applies the caps and removes keys nobody uses any more.
+    // rank is only asked when maxActors is exceeded; lower ranks are kept first.
+    CompactStats Compact(Image& img, const CompactLimits& lim, const std::function<double(std::uint32_t)>& rank);
+
+    // Exact number of bytes Encode appends for img.
+    std::size_t EncodedSize(const Image& img);
+    // Sorts img.actors by FormID (delta coding) and appends the record to out.
+    void Encode(Image& img, std::vector<std::uint8_t>& out);
+    // False on a bad magic, checksum mismatch or truncated data; img is left partially filled then.
+    bool Decode(std::span<const std::uint8_t> in, Image& img);
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Settings.h"
+
+// Compact binary capture of everything the wetness simulation reads per tick, so a reported
+// stutter or wrong result can be reproduced and measured outside the game (tools/replay).
+//
+// File layout (little endian): "SWEREC", u16 version, then tagged records
+//   'C'  u64 version, u16 count, count x (u8 type 'b'/'i'/'f', u8 nameLen, name, 4 value bytes)
+//                                                          the settings, whenever their version changed
+//   'L'  u64 version, u32 n + n FormSpec (overrides), u32 n + n FormSpec (tracked), u32 n + n u32 (enabledIDs);
+//        FormSpec = u16 len, plugin, u32 id, f32 value, u8 enabled, u8 mask, u8 autoWet
+//                                                          the actor lists, whenever their version changed
+//   'T'  f32 dt, f32 gameSecDelta, f32 stepDt (v2)         once per tick, before that tick's actors
+//   'S'  u32 formID, f32 wetness, f32 lastAppliedWet, f32 lastAppliedCat[4], f32 simCat[4], u8 simInit,
+//        f32 activityLevel, f64 simAge, u8 envClass, u16 n + n (u16 keyLen, key, f32 value, f32 expiry,
+//        u8 catMask, u32 flags)                            an actor's state, the first time a recording sees it
+//   'A'  u32 formID, u32 baseID (v2), u16 env (EnvBit), f32 submerge, u8 activity (ActBit)
+//   'G'  u32 formID                                        the actor's geometry changed, all categories re-applied
+//   'D'  u32 formID                                        reset to dry after it left the opt-in selection
+//   'X'  u8 op (ExtOp), u32 formID, f32 value, f32 expiry, u32 catMask, u32 flags, f32 ov[7],
+//        u16 keyLen, key bytes                             every external source change, from any thread
+//
+// From v2 on 'X' holds the source as stored (normalized key, clamped value, remaining time or -1) and calls that
+// changed nothing are not recorded; v1 holds the raw API arguments.
+namespace SWE::Rec {
+
+    inline constexpr char kMagic[6] = {'S', 'W', 'E', 'R', 'E', 'C'};
+    inline constexpr std::uint16_t kVersion = 2;
+
+    enum EnvBit : std::uint16_t {
+        kEnvWater = 1u << 0,
+        kEnvRain = 1u << 1,
+        kEnvSnow = 1u << 2,
+        kEnvInterior = 1u << 3,
+        kEnvExposed = 1u << 4,  // precipitation reaches the actor (no roof)
+        kEnvNearHeat = 1u << 5,
+        kEnvWaterfall = 1u << 6,
+        kEnvAllowEnv = 1u << 7,  // automatic mode, environment may wet the actor
+        kEnvManual = 1u << 8     // manual override mode
+    };
+
+    enum ActBit : std::uint8_t { kActRun = 1u << 0, kActSneak = 1u << 1, kActWork = 1u << 2 };
+
+    enum class ExtOp : std::uint8_t { Set, SetMask, SetEx, Clear };
+
+    struct TickRec {
+        float dt{0.f};
+        float gameSecDelta{0.f};
+        float stepDt{0.f};  // 0 in v1
+    };
+
+    struct ActorRec {
+        std::uint32_t formID{0};
+        std::uint32_t baseID{0};  // 0 in v1
+        std::uint16_t env{0};
+        float submerge{0.f};
+        std::uint8_t activity{0};
+    };
+
+    struct ExtRec {
+        ExtOp op{ExtOp::Set};
+        std::uint32_t formID{0};
+        float value{0.f};
+        float durationSec{-1.f};
+        std::uint32_t catMask{0};
+        std::uint32_t flags{0};
+        float ov[7]{-1.f, -1.f, -1.f, -1.f, -1.f, -1.f, -1.f};  // OverrideParams order
+        std::string key;
+    };
+
+    struct SourceRec {
+        std::string key;
+        float value{0.f};
+        float expiryRemainingSec{-1.f};
+        std::uint8_t catMask{0};
+        std::uint32_t flags{0};
+    };
+
+    struct StateRec {
+        std::uint32_t formID{0};
+        float wetness{0.f};
+        float lastAppliedWet{-1.f};
+        float lastAppliedCat[4]{-1.f, -1.f, -1.f, -1.f};
+        float simCat[4]{};
+        bool simInit{false};
+        float activityLevel{0.f};
+        double simAge{-1.0};  // simulation clock minus simTime when captured, -1 = not simulated yet
+        std::uint8_t envClass{0};
+        std::vector<SourceRec> sources;
+    };
+
+    struct Record {
+        char tag{0};  // 'C', 'L', 'T', 'S', 'A', 'G', 'D' or 'X'
+        TickRec tick;
+        ActorRec actor;
+        ExtRec ext;
+        StateRec state;
+        std::uint32_t formID{0};      // 'G', 'D'
+        Settings::Config config;      // 'C', derived fields included; settings the file does not name keep defaults
+        Settings::ActorListsSnapshot lists;  // 'L'
+    };
+
+    // Reads a capture back. Does not depend on the game, replay tools only need this header.
+    class Reader {
+    public:
+        explicit Reader(std::istream& is);
+        bool Valid() const { return _valid; }
+        std::uint16_t Version() const { return _version; }
+        // False at the end of the stream or on a truncated / unknown record.
+        bool Next(Record& out);
+
+    private:
+        std::istream& _is;
+        bool _valid{false};
+        std::uint16_t _version{0};
+    };
+
+    bool IsRecording() noexcept;
+    bool Start(const std::filesystem::path& path);
+    void Stop();
+    // Counts recordings started, from 1; state captured under an older value has to be captured again.
+    std::uint32_t Session() noexcept;
+
+    void Config(const Settings::Config& cfg);
+    void ActorLists(const Settings::ActorListsSnapshot& lists);
+    void Tick(float dt, float gameSecDelta, float stepDt);
+    void State(std::uint32_t formID, const StateRec& st);
+    void Actor(std::uint32_t formID, std::uint32_t baseID, std::uint16_t env, float submerge, std::uint8_t activity);
+    void GeomChanged(std::uint32_t formID);
+    void Deselect(std::uint32_t formID);
+    void External(ExtOp op, std::uint32_t formID, std::string_view key, float value, float durationSec,
+                  std::uint32_t catMask, std::uint32_t flags, const float* ov7 = nullptr);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+// Scoped timing of the tick phases. Build with SWE_PROFILE=1 to enable, otherwise every scope compiles to nothing.
+#ifndef SWE_PROFILE
+    #define SWE_PROFILE 0
+#endif
+
+namespace SWE::Prof {
+
+    enum class Phase : std::uint8_t {
+        Tick,
+        AllowList,
+        UpdateActor,
+        ProbeWater,
+        ProbeRoof,
+        ProbeHeat,
+        ProbeWaterfall,
+        WetByCategory,
+        StampProbe,
+        ApplyMaterials,
+        kCount
+    };
+
+    enum class Counter : std::uint8_t { Rays, Refs, Geometries, kCount };
+
+    inline constexpr std::size_t kCounterCount = static_cast<std::size_t>(Counter::kCount);
+
+    struct TraceEvent {
+        std::uint64_t startNs{0};  // relative to the capture start
+        std::uint64_t durNs{0};
+        std::uint32_t formID{0};
+        Phase phase{Phase::Tick};
+        std::uint32_t counts[kCounterCount]{};
+    };
+
+    const char* PhaseName(Phase phase) noexcept;
+
+    // Writes complete ("X") events in the Chrome trace format, loadable in chrome://tracing and Perfetto.
+    // Does not touch the game, so it can be used on any captured buffer.
+    void WriteChromeTrace(std::ostream& os, std::span<const TraceEvent> events, std::uint64_t dropped = 0);
+
+#if SWE_PROFILE
+    void Record(Phase phase, std::uint64_t ns) noexcept;
+
+    // Logs p50/p95/p99/max of the recent samples of every phase, at most once per interval.
+    void MaybeDump(std::chrono::seconds interval = 10s);
+
+    // Timeline capture. Start/stop are marshalled to the game thread, which is the only one recording scopes.
+    // The buffer is allocated on start; events past its capacity are counted as dropped.
+    void StartCapture(std::size_t maxEvents = 1u << 18);
+    // Writes the capture to SkyrimWetEffect_trace.json next to the log.
+    void StopCaptureAndWrite();
+    bool IsCapturing() noexcept;
+
+    // Adds to the innermost open scope on this thread; the value is folded into the parents when it closes.
+    void AddCount(Counter counter, std::uint32_t n = 1) noexcept;
+
+    class Scope {
+    public:
+        explicit Scope(Phase phase, std::uint32_t formID = 0) noexcept;
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        friend void AddCount(Counter counter, std::uint32_t n) noexcept;
+
+        Phase _phase;
+        std::uint32_t _formID;
+        std::uint32_t _counts[kCounterCount]{};
+        Scope* _parent;
+        std::chrono::steady_clock::time_point _t0;
+    };
+
+    #define SWE_PROF_CONCAT_(a, b) a##b
+    #define SWE_PROF_CONCAT(a, b) SWE_PROF_CONCAT_(a, b)
+    #define SWE_PROFILE_SCOPE(phase) \
+        const ::SWE::Prof::Scope SWE_PROF_CONCAT(sweProfScope_, __LINE__) { ::SWE::Prof::Phase::phase }
+    #define SWE_PROFILE_ACTOR_SCOPE(phase, formID) \
+        const ::SWE::Prof::Scope SWE_PROF_CONCAT(sweProfScope_, __LINE__) { ::SWE::Prof::Phase::phase, (formID) }
+    #define SWE_PROFILE_COUNT(counter, n) ::SWE::Prof::AddCount(::SWE::Prof::Counter::counter, (n))
+    #define SWE_PROFILE_DUMP() ::SWE::Prof::MaybeDump()
+#else
+    #define SWE_PROFILE_SCOPE(phase) ((void)0)
+    #define SWE_PROFILE_ACTOR_SCOPE(phase, formID) ((void)0)
+    #define SWE_PROFILE_COUNT(counter, n) ((void)0)
+    #define SWE_PROFILE_DUMP() ((void)0)
+#endif
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "interfaces/DynamicWetness_SharedTable.h"
+
+// Writer side of the shared-memory actor table; the layout and a reader live in the public header above.
+// Does not depend on the game. Not thread-safe, the tick is the only writer.
+namespace SWE::SharedTable {
+
+    // Creates the named mapping with room for capacity rows, or recreates it when the capacity changed.
+    // False if the OS refused; nothing is published then.
+    bool Open(std::uint32_t capacity);
+    // Publishes an empty table, then releases the mapping (readers that still have it open keep their view).
+    void Close();
+    bool IsOpen();
+    std::uint32_t Capacity();
+
+    // Replaces the table with the first Capacity() rows inside one seqlock write.
+    void Publish(std::span<const Shared::Entry> rows, std::uint64_t stateVersion);
+
+    // Cuts rows down to the capacity most recently seen and sorts them by FormID, the order readers get.
+    void Trim(std::vector<Shared::Entry>& rows, std::uint32_t capacity);
+}
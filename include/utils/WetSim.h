@@ -0,0 +1,376 @@
+#pragma once
+
+#include "Settings.h"
+
+// The per-category wetness model without the game: base drying, external source blending and expiry, and the
+// closed-form catch-up for long intervals. WetController feeds it the state it keeps per actor; the headless tests
+// and tools feed it synthetic or recorded state.
+//
+// Source maps are any map from key to a type with value, expiryRemainingSec, catMask and flags, like
+// WetController::ExternalSource. expiryRemainingSec < 0 never expires, 0 has run out.
+//
+// Actor state (UpdateActor, SettleActor, CommitApplied) is any type with the simulated members of
+// WetController::WetData: wetness, lastAppliedWet, lastAppliedCat, simCat, simInit, activityLevel, simTime, envClass
+// and extSources.
+namespace SWE::Sim {
+
+    // Same bits as SWE::Papyrus::SWE_FLAG_*, which cannot be included without the game.
+    inline constexpr std::uint32_t kFlagPassthrough = 1u << 16;
+    inline constexpr std::uint32_t kFlagNoAutoDry = 1u << 17;
+    inline constexpr std::uint32_t kFlagZeroBase = 1u << 18;
+
+    inline float Clamp01(float v) { return (v < 0.f) ? 0.f : (v > 1.f) ? 1.f : v; }
+
+    // Environment an actor was last simulated in; it is assumed to persist while nothing updates the actor.
+    enum class EnvClass : std::uint8_t { kDrying, kNearHeat, kPrecip, kWater };
+
+    // Counts timed sources down by dt and drops the ones that ran out.
+    template <class Map>
+    void ExpireSources(Map& sources, float dt) {
+        for (auto it = sources.begin(); it != sources.end();) {
+            if (it->second.expiryRemainingSec >= 0.f) {
+                it->second.expiryRemainingSec -= std::max(0.f, dt);
+                if (it->second.expiryRemainingSec <= 0.f) {
+                    it = sources.erase(it);
+                    continue;
+                }
+            }
+            ++it;
+        }
+    }
+
+    // One regular step of length dt with the sources that are live after ExpireSources(dt): dries the base of every
+    // category, blends the sources in, and writes the result to both out and simCat.
+    template <class Map>
+    void Step(float simCat[4], const float lastApplied[4], const Map& sources, float dt, float dryMul,
+              const Settings::Config& cfg, float out[4]) {
+        float base[4];
+        for (int ci = 0; ci < 4; ++ci) base[ci] = Clamp01(simCat[ci] - cfg.dryRate[ci] * dryMul * dt);
+
+        float pass[4]{}, sum[4]{}, mx[4]{};
+        bool any[4]{}, zeroBase[4]{}, noAutoDry[4]{};
+        for (const auto& [k, s] : sources) {
+            if (s.expiryRemainingSec == 0.f) continue;
+            const bool isPT = (s.flags & kFlagPassthrough) != 0;
+            for (int ci = 0; ci < 4; ++ci) {
+                if ((s.catMask & (1u << ci)) == 0) continue;
+                zeroBase[ci] |= (s.flags & kFlagZeroBase) != 0;
+                noAutoDry[ci] |= (s.flags & kFlagNoAutoDry) != 0;
+                if (isPT) {
+                    pass[ci] += s.value;
+                    continue;
+                }
+                any[ci] = true;
+                sum[ci] += s.value;
+                mx[ci] = std::max(mx[ci], s.value);
+            }
+        }
+
+        for (int ci = 0; ci < 4; ++ci) {
+            if (zeroBase[ci])
+                base[ci] = 0.f;
+            else if (noAutoDry[ci])
+                base[ci] = lastApplied[ci];
+
+            float w = base[ci];
+            if (any[ci]) {
+                switch (cfg.externalBlendMode) {
+                    default:
+                    case 0:
+                        w = std::max(base[ci], mx[ci]);
+                        break;
+                    case 1:
+                        w = Clamp01(base[ci] + sum[ci]);
+                        break;
+                    case 2:
+                        w = Clamp01(std::max(base[ci], mx[ci]) +
+                                    std::max(0.f, sum[ci] - mx[ci]) * Clamp01(cfg.externalAddWeight));
+                        break;
+                }
+            }
+            out[ci] = Clamp01(w + pass[ci]);
+            simCat[ci] = out[ci];
+        }
+    }
+
+    // n = span / step regular steps of s' = clamp(max(clamp(s - rate * step), floor) + add), in O(1).
+    float AdvanceCat(float s, float span, float step, float rate, float floor, float add);
+
+    // What Step() does to simCat over span, as if span / step regular steps (each preceded by ExpireSources(step))
+    // had run: the interval is split where a source runs out and every piece is advanced with AdvanceCat. Sources
+    // are only read, callers that keep the result count them down with ExpireSources(span) afterwards.
+    template <class Map>
+    void CatchUp(float simCat[4], const float lastApplied[4], const Map& sources, float span, float step,
+                 float dryMul, const Settings::Config& cfg) {
+        // A regular step drops a source before blending in the step it runs out, so one with r seconds left at
+        // elapsed time t still counts for ceil((r - t) / step) - 1 steps
+        auto liveSteps = [&](const auto& s, float t) {
+            return (s.expiryRemainingSec < 0.f) ? FLT_MAX : std::ceil((s.expiryRemainingSec - t) / step) - 1.f;
+        };
+
+        float t = 0.f;
+        while (span > 0.f) {
+            // the live sources, and with them floor and add, only change on the step one drops out
+            float seg = span;
+            for (const auto& [k, s] : sources) {
+                const float live = liveSteps(s, t);
+                if (live >= 1.f && live < FLT_MAX) seg = std::min(seg, live * step);
+            }
+
+            for (int ci = 0; ci < 4; ++ci) {
+                float sum = 0.f, mx = 0.f, pass = 0.f;
+                bool any = false, zeroBase = false, noAutoDry = false;
+                for (const auto& [k, s] : sources) {
+                    if (liveSteps(s, t) < 1.f || (s.catMask & (1u << ci)) == 0) continue;
+                    zeroBase |= (s.flags & kFlagZeroBase) != 0;
+                    noAutoDry |= (s.flags & kFlagNoAutoDry) != 0;
+                    if ((s.flags & kFlagPassthrough) != 0) {
+                        pass += s.value;
+                        continue;
+                    }
+                    any = true;
+                    sum += s.value;
+                    mx = std::max(mx, s.value);
+                }
+
+                // the blend modes of Step written as max(base, floor) + add
+                float floor = 0.f, add = pass;
+                if (any) {
+                    switch (cfg.externalBlendMode) {
+                        default:
+                        case 0:
+                            floor = mx;
+                            break;
+                        case 1:
+                            add += sum;
+                            break;
+                        case 2:
+                            floor = mx;
+                            add += std::max(0.f, sum - mx) * Clamp01(cfg.externalAddWeight);
+                            break;
+                    }
+                }
+
+                float& s = simCat[ci];
+                if (zeroBase || noAutoDry) {
+                    // the base is pinned, so every step produces the same value
+                    const float base = zeroBase ? 0.f : std::max(0.f, lastApplied[ci]);
+                    s = Clamp01(std::max(base, floor) + add);
+                } else {
+                    s = AdvanceCat(s, seg, step, cfg.dryRate[ci] * dryMul, floor, add);
+                }
+            }
+            t += seg;
+            span -= seg;
+        }
+    }
+
+    // Brings simCat forward by gap for an actor that stayed in env all along and returns its final wetness (the
+    // largest enabled category). Soaking overrides every category as in the tick, snow is taken at the rain rate.
+    // Sources are only read, as in CatchUp.
+    template <class Map>
+    float Settle(float simCat[4], const float lastApplied[4], const Map& sources, float gap, EnvClass env,
+                 float step, const Settings::Config& cfg) {
+        if (env == EnvClass::kWater || env == EnvClass::kPrecip) {
+            const float rate = (env == EnvClass::kWater) ? cfg.soakWaterRate : cfg.soakRainRate;
+            const float w = std::min(1.f, std::max(std::max(simCat[0], simCat[1]), std::max(simCat[2], simCat[3])) +
+                                              rate * gap);
+            for (int ci = 0; ci < 4; ++ci) simCat[ci] = w;
+        } else {
+            CatchUp(simCat, lastApplied, sources, gap, step, (env == EnvClass::kNearHeat) ? cfg.heatDryMul : 1.f,
+                    cfg);
+        }
+
+        float w = 0.f;
+        for (int ci = 0; ci < 4; ++ci)
+            if (cfg.catEnabledMask & (1u << ci)) w = std::max(w, simCat[ci]);
+        return w;
+    }
+
+    // Same as the SWE_CAT_MASK_4BIT bits a source applies to.
+    inline constexpr std::uint8_t kCatMask = 0x0F;
+    // At or below this an actor counts as dry, above kApplyDelta a category is applied again.
+    inline constexpr float kDryWetness = 0.0005f;
+    inline constexpr float kApplyDelta = 0.0025f;
+    // Regular steps a tick may cover before all but the last one are integrated in closed form.
+    inline constexpr float kCatchUpSteps = 4.f;
+    inline constexpr const char* kActivityKey = "__activity";
+
+    // Brings an actor that was not updated since wd.simTime up to until, assuming it stayed in wd.envClass.
+    template <class Data>
+    void SettleActor(Data& wd, double until, float step, const Settings::Config& cfg) {
+        if (wd.simTime < 0.0 || until - wd.simTime < 1e-3) return;
+        const float gap = static_cast<float>(until - wd.simTime);
+        wd.simTime = until;
+        if (!wd.simInit) {
+            for (int i = 0; i < 4; ++i) wd.simCat[i] = std::max(0.f, wd.lastAppliedCat[i]);
+            wd.simInit = true;
+        }
+        wd.wetness = Settle(wd.simCat, wd.lastAppliedCat, wd.extSources, gap, wd.envClass, step, cfg);
+        ExpireSources(wd.extSources, gap);
+    }
+
+    // What one tick probed for an actor, everything UpdateActor reads besides its state and the config.
+    struct ActorInput {
+        double clock{0.0};  // the simulation clock after this tick
+        float dt{0.f};      // this tick, including the game time that passed meanwhile
+        float step{0.f};    // length of a regular tick
+        bool allowEnvWet{false};
+        bool inWater{false};
+        bool nearWaterfall{false};
+        bool exposed{false};  // precipitation reaches the actor
+        bool rain{false};
+        bool snow{false};
+        bool nearHeat{false};  // never set in water
+        bool active{false};    // running, sneaking or working, never in water
+        bool forced{false};    // manual mode and the actor lists force a value
+        float forcedWet{0.f};
+        std::uint8_t forcedMask{0};
+
+        bool EnvDominates() const { return allowEnvWet && (inWater || nearWaterfall || exposed); }
+        float DryMul(const Settings::Config& cfg) const { return (nearHeat && !exposed) ? cfg.heatDryMul : 1.f; }
+    };
+
+    // One tick of an actor: soaking, activity, source expiry and blending, the catch-up for a long dt, and the
+    // forced and disabled categories. Writes the wetness per category to out and returns the final wetness; the
+    // caller stores it in wd.wetness once it has compared it with the previous value.
+    template <class Data>
+    float UpdateActor(Data& wd, const ActorInput& in, const Settings::Config& cfg, float out[4]) {
+        const float dryMul = in.DryMul(cfg);
+        wd.simTime = in.clock;
+        if (in.inWater || in.nearWaterfall)
+            wd.envClass = EnvClass::kWater;
+        else if (in.exposed)
+            wd.envClass = EnvClass::kPrecip;
+        else
+            wd.envClass = (dryMul > 1.f) ? EnvClass::kNearHeat : EnvClass::kDrying;
+
+        float dt = in.dt;
+        const float prevMax = std::max(std::max(wd.lastAppliedCat[0], wd.lastAppliedCat[1]),
+                                       std::max(wd.lastAppliedCat[2], wd.lastAppliedCat[3]));
+        float w = std::max(wd.wetness, prevMax);
+
+        const bool envDominates = in.EnvDominates();
+        if (in.inWater) {
+            w += cfg.soakWaterRate * dt;
+        } else if (in.nearWaterfall) {
+            w += cfg.soakWaterfallRate * dt;
+        } else if (in.exposed) {
+            float inc = 0.0f;
+            if (in.rain) inc = std::max(inc, cfg.soakRainRate * dt);
+            if (in.snow) inc = std::max(inc, cfg.soakSnowRate * dt);
+            w += inc;
+        }
+
+        if (cfg.activityWetEnabled && cfg.activityMask != 0) {
+            if (in.active && !envDominates)
+                wd.activityLevel = Clamp01(wd.activityLevel + cfg.soakActivityRate * dt);
+            else
+                wd.activityLevel = Clamp01(wd.activityLevel - cfg.dryActivityRate * dt);
+
+            if (wd.activityLevel > kDryWetness) {
+                auto& src = wd.extSources[kActivityKey];
+                src.value = wd.activityLevel;
+                src.expiryRemainingSec = -1.f;
+                src.catMask = cfg.activityMask;
+                src.flags = 0;
+            } else {
+                wd.extSources.erase(kActivityKey);
+            }
+        } else {
+            wd.activityLevel = 0.f;
+            wd.extSources.erase(kActivityKey);
+        }
+
+        // the environment and other sources take over from activity
+        const bool otherSource = std::any_of(wd.extSources.begin(), wd.extSources.end(), [](const auto& kv) {
+            const auto& src = kv.second;
+            if (kv.first == kActivityKey || src.expiryRemainingSec == 0.f) return false;
+            return src.value > 0.f && (src.catMask & kCatMask) != 0;
+        });
+        if (envDominates || otherSource) {
+            wd.activityLevel = 0.0f;
+            wd.extSources.erase(kActivityKey);
+        }
+
+        w = Clamp01(w);
+
+        if (!wd.simInit) {
+            for (int i = 0; i < 4; ++i) wd.simCat[i] = wd.lastAppliedCat[i];
+            wd.simInit = true;
+        }
+
+        // Waiting, sleeping, fast travel and hitches arrive as one long dt. All but the last regular step is
+        // integrated in closed form so the result matches regular ticks instead of depending on the skip length.
+        if (!envDominates && dt > kCatchUpSteps * in.step) {
+            CatchUp(wd.simCat, wd.lastAppliedCat, wd.extSources, dt - in.step, in.step, dryMul, cfg);
+            ExpireSources(wd.extSources, dt - in.step);
+            dt = in.step;
+        }
+        ExpireSources(wd.extSources, dt);
+
+        // Important: Environmental wetness sources override everything else
+        if (envDominates) {
+            for (int i = 0; i < 4; ++i) out[i] = wd.simCat[i] = w;
+        } else {
+            Step(wd.simCat, wd.lastAppliedCat, wd.extSources, dt, dryMul, cfg, out);
+        }
+
+        if (in.forced) {
+            for (int ci = 0; ci < 4; ++ci)
+                if (in.forcedMask & (1u << ci)) out[ci] = in.forcedWet;
+        }
+        for (int ci = 0; ci < 4; ++ci)
+            if (!(cfg.catEnabledMask & (1u << ci))) out[ci] = 0.0f;
+
+        return std::max(std::max(out[0], out[1]), std::max(out[2], out[3]));
+    }
+
+    // Categories that moved far enough from what was last applied to be applied again.
+    inline std::uint8_t ChangedCategories(const float lastApplied[4], const float wetByCat[4]) {
+        std::uint8_t mask = 0;
+        for (int i = 0; i < 4; ++i)
+            if (std::abs(lastApplied[i] - wetByCat[i]) > kApplyDelta) mask |= static_cast<std::uint8_t>(1u << i);
+        return mask;
+    }
+
+    // Records what the tick applies after UpdateActor and returns the categories to apply: all of them with
+    // geomChanged (new equipment), the changed ones otherwise, and the ones still carrying wetness (to be restored
+    // with zeros) once the actor dried off.
+    template <class Data>
+    std::uint8_t CommitApplied(Data& wd, const float wetByCat[4], float wFinal, bool geomChanged) {
+        if (wFinal <= kDryWetness) {
+            const float prevMax = std::max(std::max(wd.lastAppliedCat[0], wd.lastAppliedCat[1]),
+                                           std::max(wd.lastAppliedCat[2], wd.lastAppliedCat[3]));
+            if (prevMax <= kDryWetness) return 0;
+            std::uint8_t restoreMask = 0;
+            for (int i = 0; i < 4; ++i) {
+                if (wd.lastAppliedCat[i] > 0.0f) restoreMask |= static_cast<std::uint8_t>(1u << i);
+                wd.lastAppliedCat[i] = 0.f;
+                wd.simCat[i] = 0.f;
+            }
+            wd.lastAppliedWet = 0.0f;
+            wd.simInit = true;
+            return restoreMask;
+        }
+
+        const std::uint8_t mask = geomChanged ? kCatMask : ChangedCategories(wd.lastAppliedCat, wetByCat);
+        if (!mask) return 0;
+        // categories below the change threshold keep their last applied value so drift still accumulates
+        for (int i = 0; i < 4; ++i)
+            if (mask & (1u << i)) wd.lastAppliedCat[i] = wetByCat[i];
+        wd.lastAppliedWet = std::max(std::max(wd.lastAppliedCat[0], wd.lastAppliedCat[1]),
+                                     std::max(wd.lastAppliedCat[2], wd.lastAppliedCat[3]));
+        return mask;
+    }
+
+    // What the actor lists say about one actor.
+    struct Policy {
+        bool listed{false};  // in the opt-in allow set
+        bool autoWet{true};  // tracked as Automatic (default) or Manual
+        bool hasOverride{false};
+        float forcedWet{0.f};
+        std::uint8_t forcedMask{kCatMask};
+    };
+    Policy ResolvePolicy(const Settings::ActorListsSnapshot& lists, std::uint32_t refID, std::uint32_t baseID);
+}
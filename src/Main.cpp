@@ -154,34 +154,68 @@ extern "C" {
     }
 
     __declspec(dllexport) unsigned SWE_GetEnvMask(RE::Actor* a) {
-        unsigned m = 0;
         auto* wc = SWE::WetController::GetSingleton();
-        if (!a || !wc) return m;
+        return (a && wc) ? wc->GetEnvMask(a) : 0u;
+    }
 
-        if (wc->IsActorWetByWater(a)) {
-            m |= SWE::Util::SWE_ENV_WATER;
-        }
+    // maxAgeSec <= 0 forces a fresh probe; outAgeSec (optional) receives the age of the returned mask
+    __declspec(dllexport) unsigned SWE_GetEnvMaskEx(RE::Actor* a, float maxAgeSec, float* outAgeSec) {
+        if (outAgeSec) *outAgeSec = 0.f;
+        auto* wc = SWE::WetController::GetSingleton();
+        return (a && wc) ? wc->GetEnvMask(a, maxAgeSec, outAgeSec) : 0u;
+    }
 
-        const bool wetWorld = wc->IsWetWeatherAround(a);
-        if (wetWorld) {
-            m |= SWE::Util::SWE_ENV_WET_WEATHER;
-        }
+    // outCatWetness holds 4 floats per actor; any out array may be null. Returns how many of the actors SWE tracks.
+    __declspec(dllexport) unsigned SWE_GetActorStates(RE::Actor* const* actors, unsigned count, float* outWetness,
+                                                      float* outCatWetness, unsigned* outEnvMask) {
+        auto* wc = SWE::WetController::GetSingleton();
+        if (!actors || !wc) return 0;
+        return static_cast<unsigned>(
+            wc->QueryActors(std::span(actors, count), outWetness, outCatWetness, outEnvMask));
+    }
 
-        const float heatR = std::max(50.0f, Settings::nearFireRadius.load());
-        if (wc->IsNearHeatSource(a, heatR)) {
-            m |= SWE::Util::SWE_ENV_NEAR_HEAT;
-        }
+    // Fills up to capacity entries for the actors SWE simulates and returns how many there are in total.
+    __declspec(dllexport) unsigned SWE_GetTrackedActorStates(unsigned* outFormIDs, unsigned capacity,
+                                                             float* outWetness, float* outCatWetness,
+                                                             unsigned* outEnvMask) {
+        auto* wc = SWE::WetController::GetSingleton();
+        if (!wc) return 0;
+        if (!outFormIDs) capacity = 0;
+        return static_cast<unsigned>(
+            wc->QueryTrackedActors(std::span(outFormIDs, capacity), outWetness, outCatWetness, outEnvMask));
+    }
 
-        const bool underRoof = wc->IsUnderRoof(a);
-        if (underRoof) {
-            m |= SWE::Util::SWE_ENV_UNDER_ROOF;
-        }
+    // formID 0 = every simulated actor; cb null = SKSE message instead. Returns 0 if threshold is not in (0, 1].
+    __declspec(dllexport) unsigned SWE_SubscribeWetness(unsigned formID, float threshold, float hysteresis,
+                                                        SWE::WetController::WetnessCallback cb, void* user) {
+        auto* wc = SWE::WetController::GetSingleton();
+        return wc ? wc->Subscribe(formID, threshold, hysteresis, cb, user) : 0u;
+    }
 
-        if (wc->IsActorInExteriorWet(a) && !underRoof) {
-            m |= SWE::Util::SWE_ENV_EXTERIOR_OPEN;
-        }
+    __declspec(dllexport) bool SWE_UnsubscribeWetness(unsigned id) {
+        auto* wc = SWE::WetController::GetSingleton();
+        return wc && wc->Unsubscribe(id);
+    }
 
-        return m;
+    __declspec(dllexport) std::uint64_t SWE_GetStateVersion() {
+        auto* wc = SWE::WetController::GetSingleton();
+        return wc ? wc->GetStateVersion() : 0;
+    }
+
+    __declspec(dllexport) bool SWE_GetPerfCounters(SWE::WetController::PerfCounters* out) {
+        auto* wc = SWE::WetController::GetSingleton();
+        if (!out || !wc) return false;
+
+        // Callers built against an older header pass a smaller size, only fill what they know about
+        const std::uint32_t want = out->size;
+        if (want < offsetof(SWE::WetController::PerfCounters, total)) return false;
+
+        SWE::WetController::PerfCounters pc{};
+        wc->GetPerfCounters(pc);
+        const std::uint32_t n = std::min<std::uint32_t>(want, sizeof(pc));
+        pc.size = n;
+        std::memcpy(out, &pc, n);
+        return true;
     }
 
 }
@@ -203,6 +237,7 @@ extern "C" __declspec(dllexport) bool SKSEPlugin_Load(const SKSE::LoadInterface*
         auto* wc = SWE::WetController::GetSingleton();
         switch (msg->type) {
             case SKSE::MessagingInterface::kDataLoaded:
+                Settings::RebaseActorLists();
                 wc->Install();
                 if (const auto pap = SKSE::GetPapyrusInterface(); pap) {
                     pap->Register(SWE::Papyrus::Register);
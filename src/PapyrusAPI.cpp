@@ -73,17 +73,28 @@ namespace SWE::Papyrus {
         return (a && wc) ? wc->IsWetWeatherAround(a) : false;
     }
     std::int32_t GetEnvMask(RE::StaticFunctionTag*, RE::Actor* a) {
-        if (!a) return 0;
-        std::uint32_t m = 0;
         auto* wc = SWE::WetController::GetSingleton();
-        if (!wc) return 0;
-        if (wc->IsActorWetByWater(a)) m |= SWE::Papyrus::SWE_ENV_WATER;
-        if (wc->IsWetWeatherAround(a)) m |= SWE::Papyrus::SWE_ENV_WET_WEATHER;
-        if (wc->IsNearHeatSource(a, std::max(50.0f, Settings::nearFireRadius.load())))
-            m |= SWE::Papyrus::SWE_ENV_NEAR_HEAT;
-        if (wc->IsUnderRoof(a)) m |= SWE::Papyrus::SWE_ENV_UNDER_ROOF;
-        if (wc->IsActorInExteriorWet(a) && !wc->IsUnderRoof(a)) m |= SWE::Papyrus::SWE_ENV_EXTERIOR_OPEN;
-        return static_cast<std::int32_t>(m);
+        return (a && wc) ? static_cast<std::int32_t>(wc->GetEnvMask(a)) : 0;
+    }
+    float GetPerfCounter(RE::StaticFunctionTag*, std::int32_t counter, bool perSecond) {
+        auto* wc = SWE::WetController::GetSingleton();
+        if (!wc || counter < 0) return 0.0f;
+
+        SWE::WetController::PerfCounters pc{};
+        wc->GetPerfCounters(pc);
+        if (counter < SWE::WetController::kPerfCount) {
+            return perSecond ? static_cast<float>(pc.perSecond[counter]) : static_cast<float>(pc.total[counter]);
+        }
+        switch (counter - SWE::WetController::kPerfCount) {
+            case 0:
+                return static_cast<float>(pc.bytesWetData);
+            case 1:
+                return static_cast<float>(pc.bytesMatCache);
+            case 2:
+                return static_cast<float>(pc.bytesSources);
+            default:
+                return 0.0f;
+        }
     }
 
     bool Register(RE::BSScript::IVirtualMachine* vm) {
@@ -101,6 +112,7 @@ namespace SWE::Papyrus {
         vm->RegisterFunction("GetSubmergedLevel", "SWE", GetSubmergedLevel);
         vm->RegisterFunction("IsWetWeatherAround", "SWE", IsWetWeatherAround);
         vm->RegisterFunction("GetEnvMask", "SWE", GetEnvMask);
+        vm->RegisterFunction("GetPerfCounter", "SWE", GetPerfCounter);
         return true;
     }
 }
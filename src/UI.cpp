@@ -1,5 +1,7 @@
 ﻿#include "UI.h"
 
+#include "utils/InputRecorder.h"
+#include "utils/Profiler.h"
 #include "utils/Utils.h"
 
 #ifndef IM_ARRAYSIZE
@@ -316,6 +318,69 @@ void __stdcall UI::WetConfig::RenderGeneral() {
                        "How often the logic runs. Higher = less frequent.")) {
             Settings::updateIntervalMs.store(upd);
         }
+
+        int geomCap = Settings::maxGeomAppliesPerTick.load();
+        if (IntControl("Max Material Updates per Tick", geomCap, 0, 1024, "%d", 8, 32,
+                       "Caps how many geometries get their material refreshed per update. Remaining actors are "
+                       "caught up over the next updates, nearest first. 0 = unlimited.")) {
+            Settings::maxGeomAppliesPerTick.store(geomCap);
+        }
+
+        bool offscreen = Settings::deferOffscreenApplies.load();
+        if (ImGui::Checkbox("Defer off-screen NPC updates", &offscreen))
+            Settings::deferOffscreenApplies.store(offscreen);
+        HelpMarker("NPCs behind the camera or with culled 3D keep drying/soaking, but their materials are only "
+                   "refreshed once they are visible again.");
+
+        int saveActors = Settings::saveMaxActors.load();
+        if (IntControl("Max Actors in Save", saveActors, 0, 8192, "%d", 16, 256,
+                       "How many actors' wetness is written to the save. The player, then the nearest loaded and "
+                       "most recently seen NPCs are kept. 0 = unlimited.")) {
+            Settings::saveMaxActors.store(saveActors);
+        }
+
+        int saveSources = Settings::saveMaxSourcesPerActor.load();
+        if (IntControl("Max External Sources per Actor in Save", saveSources, 0, 256, "%d", 1, 8,
+                       "Only the strongest external sources of each actor are saved. Sources about to expire are "
+                       "never saved. 0 = unlimited.")) {
+            Settings::saveMaxSourcesPerActor.store(saveSources);
+        }
+
+        int coldActors = Settings::coldMaxActors.load();
+        if (IntControl("Max Unloaded Actors Remembered", coldActors, 0, 65536, "%d", 64, 1024,
+                       "NPCs that unload while wet keep a small record (16 bytes) so they are still wet when they "
+                       "come back. Beyond this count the longest-unseen are forgotten. 0 = unlimited.")) {
+            Settings::coldMaxActors.store(coldActors);
+        }
+
+        int coldAge = Settings::coldMaxAgeMin.load();
+        if (IntControl("Forget Unloaded Actors After (min)", coldAge, 0, 1440, "%d", 10, 60,
+                       "Real-time minutes after which an unloaded NPC's wetness is forgotten. 0 = never.")) {
+            Settings::coldMaxAgeMin.store(coldAge);
+        }
+
+        if (!SWE::Rec::IsRecording()) {
+            if (ImGui::Button("Start Input Recording")) {
+                if (auto path = logger::log_directory()) {
+                    *path /= "SkyrimWetEffect_inputs.swerec";
+                    SWE::Rec::Start(*path);
+                }
+            }
+        } else if (ImGui::Button("Stop Input Recording")) {
+            SWE::Rec::Stop();
+        }
+        HelpMarker("Records the settings, actor lists and every tick's inputs (timing, environment, activity, API "
+                   "calls) to SkyrimWetEffect_inputs.swerec next to the log; tools/replay runs it offline.");
+
+#if SWE_PROFILE
+        if (!SWE::Prof::IsCapturing()) {
+            if (ImGui::Button("Start Trace Capture")) SWE::Prof::StartCapture();
+        } else if (ImGui::Button("Stop and Write Trace")) {
+            SWE::Prof::StopCaptureAndWrite();
+        }
+        HelpMarker("Records a timeline of ticks, probes and material updates and writes "
+                   "SkyrimWetEffect_trace.json next to the log (open in chrome://tracing or Perfetto).");
+#endif
     }
     FontAwesome::Pop();
 
@@ -336,10 +401,41 @@ void __stdcall UI::WetConfig::RenderGeneral() {
                 Settings::externalAddWeight.store(w);
             }
         }
+
+        float evThr = Settings::modEventThreshold.load();
+        if (FloatControl("Papyrus event threshold", evThr, 0.f, 1.f, "%.2f", 0.01f, 0.05f,
+                         "Sends the SWE_WetnessChanged ModEvent when final wetness reaches this value (\"wet\") and "
+                         "when it falls back below it minus the hysteresis (\"dry\"). 0 = no events.")) {
+            Settings::modEventThreshold.store(evThr);
+        }
+        if (evThr > 0.f) {
+            float evHys = Settings::modEventHysteresis.load();
+            if (FloatControl("Papyrus event hysteresis", evHys, 0.f, 0.5f, "%.2f", 0.01f, 0.05f,
+                             "How far wetness has to drop below the threshold before the \"dry\" event.")) {
+                Settings::modEventHysteresis.store(evHys);
+            }
+            bool evPlayer = Settings::modEventPlayerOnly.load();
+            if (ImGui::Checkbox("Papyrus events for the player only", &evPlayer))
+                Settings::modEventPlayerOnly.store(evPlayer);
+        }
+
+        bool shared = Settings::sharedTableEnabled.load();
+        if (ImGui::Checkbox("Publish shared-memory table", &shared)) Settings::sharedTableEnabled.store(shared);
+        HelpMarker("Writes every simulated actor's wetness and environment into a named shared-memory table on each "
+                   "update, for overlays and tools in other processes (see DynamicWetness_SharedTable.h).");
+        if (shared) {
+            int rows = Settings::sharedTableMaxActors.load();
+            if (IntControl("Shared table rows", rows, 1, 4096, "%d", 16, 128,
+                           "Room for this many actors; beyond it the most recently seen are published.")) {
+                Settings::sharedTableMaxActors.store(rows);
+            }
+        }
     }
 
     ImGui::Separator();
     SaveResetRow(true);
+
+    Settings::PublishConfigIfChanged();
 }
 
 void __stdcall UI::WetConfig::RenderSources() {
@@ -514,6 +610,8 @@ void __stdcall UI::WetConfig::RenderSources() {
         SaveResetRow();
     }
     FontAwesome::Pop();
+
+    Settings::PublishConfigIfChanged();
 }
 
 void __stdcall UI::WetConfig::RenderMaterials() {
@@ -664,6 +762,8 @@ void __stdcall UI::WetConfig::RenderMaterials() {
         SaveResetRow(true);
     }
     FontAwesome::Pop();
+
+    Settings::PublishConfigIfChanged();
 }
 
 void __stdcall UI::WetConfig::RenderNPCs() {
@@ -727,7 +827,7 @@ void __stdcall UI::WetConfig::RenderNPCs() {
                         ImGui::SameLine();
                         if (ImGui::SmallButton("Add")) {
                             {
-                                std::unique_lock lk(Settings::actorsMutex);
+                                Settings::ActorListsEdit edit;
                                 if (!find_by_id(Settings::trackedActors, fid)) {
                                     std::string plugin;
                                     if (auto* f = ab->GetFile(0)) plugin = f->GetFilename();
@@ -766,7 +866,7 @@ void __stdcall UI::WetConfig::RenderNPCs() {
                         if (res.ec == std::errc()) {
                             std::string plugin = addHexPlugin;
                             {
-                                std::unique_lock lk(Settings::actorsMutex);
+                                Settings::ActorListsEdit edit;
                                 if (!find_by_id(Settings::trackedActors, id))
                                     Settings::trackedActors.push_back({plugin, id, 1.0f, true, 0x0F});
                                 if (!find_by_id(Settings::actorOverrides, id))
@@ -808,7 +908,7 @@ void __stdcall UI::WetConfig::RenderNPCs() {
                             ImGui::SameLine();
                             if (ImGui::SmallButton("Add")) {
                                 {
-                                    std::unique_lock lk(Settings::actorsMutex);
+                                    Settings::ActorListsEdit edit;
                                     if (!find_by_id(Settings::trackedActors, fid))
                                         Settings::trackedActors.push_back({"", fid, 1.0f, true, 0x0F});
                                 }
@@ -830,7 +930,7 @@ void __stdcall UI::WetConfig::RenderNPCs() {
                 ImGui::TextWrapped("This will remove all tracked actors and manual overrides. Continue?");
                 if (ImGui::Button("Yes, clear")) {
                     {
-                        std::unique_lock lk(Settings::actorsMutex);
+                        Settings::ActorListsEdit edit;
                         Settings::actorOverrides.clear();
                         Settings::trackedActors.clear();
                     }
@@ -846,8 +946,9 @@ void __stdcall UI::WetConfig::RenderNPCs() {
         }
 
         // Snapshots
-        auto trackedSnap = Settings::SnapshotTrackedActors();
-        auto overridesSnap = Settings::SnapshotActorOverrides();
+        const auto lists = Settings::GetActorListsSnapshot();
+        const auto& trackedSnap = lists->tracked;
+        const auto& overridesSnap = lists->overrides;
 
         std::vector<std::uint32_t> ids;
         ids.reserve(trackedSnap.size() + overridesSnap.size());
@@ -900,26 +1001,28 @@ void __stdcall UI::WetConfig::RenderNPCs() {
                 int modeIdx = autoWet ? 0 : 1;
                 if (ImGui::Combo("##mode", &modeIdx, "Automatic\0Manual\0")) {
                     autoWet = (modeIdx == 0);
-                    std::unique_lock lk(Settings::actorsMutex);
-                    // ensure tracked exists
-                    auto it = std::find_if(Settings::trackedActors.begin(), Settings::trackedActors.end(),
-                                           [&](const Settings::FormSpec& fs) { return fs.id == fid; });
-                    std::string pluginName;
-                    if (auto* npc = RE::TESForm::LookupByID<RE::TESNPC>(fid)) {
-                        if (auto* f = npc->GetFile(0)) pluginName = f->GetFilename();
-                    }
-                    if (it == Settings::trackedActors.end()) {
-                        Settings::trackedActors.push_back(
-                            {pluginName, fid, /*value*/ 1.0f, /*enabled*/ true, 0x0F /*mask*/});
-                    } else {
-                        it->autoWet = autoWet;
-                    }
-                    if (!autoWet) {
-                        auto o = std::find_if(Settings::actorOverrides.begin(), Settings::actorOverrides.end(),
-                                              [&](const Settings::FormSpec& fs) { return fs.id == fid; });
-                        if (o == Settings::actorOverrides.end())
-                            Settings::actorOverrides.push_back(
+                    {
+                        Settings::ActorListsEdit edit;
+                        // ensure tracked exists
+                        auto it = std::find_if(Settings::trackedActors.begin(), Settings::trackedActors.end(),
+                                               [&](const Settings::FormSpec& fs) { return fs.id == fid; });
+                        std::string pluginName;
+                        if (auto* npc = RE::TESForm::LookupByID<RE::TESNPC>(fid)) {
+                            if (auto* f = npc->GetFile(0)) pluginName = f->GetFilename();
+                        }
+                        if (it == Settings::trackedActors.end()) {
+                            Settings::trackedActors.push_back(
                                 {pluginName, fid, /*value*/ 1.0f, /*enabled*/ true, 0x0F /*mask*/});
+                        } else {
+                            it->autoWet = autoWet;
+                        }
+                        if (!autoWet) {
+                            auto o = std::find_if(Settings::actorOverrides.begin(), Settings::actorOverrides.end(),
+                                                  [&](const Settings::FormSpec& fs) { return fs.id == fid; });
+                            if (o == Settings::actorOverrides.end())
+                                Settings::actorOverrides.push_back(
+                                    {pluginName, fid, /*value*/ 1.0f, /*enabled*/ true, 0x0F /*mask*/});
+                        }
                     }
                     SWE::WetController::GetSingleton()->RefreshNow();
                 }
@@ -931,17 +1034,13 @@ void __stdcall UI::WetConfig::RenderNPCs() {
                 float v = ovrS ? ovrS->value : 1.0f;
                 if (!manual) ImGui::BeginDisabled();
                 if (ImGui::SliderFloat("##w", &v, 0.0f, 1.0f, "%.2f", ImGuiSliderFlags_AlwaysClamp)) {
-                    std::unique_lock lk(Settings::actorsMutex);
-                    auto* o = [&]() {
-                        auto it = std::find_if(Settings::actorOverrides.begin(), Settings::actorOverrides.end(),
-                                               [&](const Settings::FormSpec& fs) { return fs.id == fid; });
-                        if (it == Settings::actorOverrides.end()) {
+                    {
+                        Settings::ActorListsEdit edit;
+                        if (auto* o = find_by_id(Settings::actorOverrides, fid))
+                            o->value = v;
+                        else
                             Settings::actorOverrides.push_back({"", fid, v, true, 0x0F});
-                            return &Settings::actorOverrides.back();
-                        }
-                        return &(*it);
-                    }();
-                    o->value = v;
+                    }
                     SWE::WetController::GetSingleton()->RefreshNow();
                 }
                 if (!manual) ImGui::EndDisabled();
@@ -963,7 +1062,7 @@ void __stdcall UI::WetConfig::RenderNPCs() {
                 std::uint8_t newMask = (mSkin ? 1 : 0) | (mHair ? 2 : 0) | (mArmor ? 4 : 0) | (mWeapon ? 8 : 0);
                 if (newMask != maskCur) {
                     {
-                        std::unique_lock lk(Settings::actorsMutex);
+                        Settings::ActorListsEdit edit;
                         auto* o = find_by_id(Settings::actorOverrides, fid);
                         if (!o)
                             Settings::actorOverrides.push_back({"", fid, 1.0f, (newMask != 0), newMask});
@@ -985,7 +1084,7 @@ void __stdcall UI::WetConfig::RenderNPCs() {
                 bool bothEn = ((ovrS && ovrS->enabled) || (trkS && trkS->enabled));
                 if (ImGui::Checkbox("##en", &bothEn)) {
                     {
-                        std::unique_lock lk(Settings::actorsMutex);
+                        Settings::ActorListsEdit edit;
                         if (auto* o = find_by_id(Settings::actorOverrides, fid)) {
                             o->enabled = bothEn;
                         }
@@ -1002,7 +1101,7 @@ void __stdcall UI::WetConfig::RenderNPCs() {
                 ImGui::TableSetColumnIndex(5);
                 if (ImGui::SmallButton("X")) {
                     {
-                        std::unique_lock lk(Settings::actorsMutex);
+                        Settings::ActorListsEdit edit;
                         remove_from(Settings::actorOverrides, fid);
                         remove_from(Settings::trackedActors, fid);
                     }
@@ -1020,4 +1119,6 @@ void __stdcall UI::WetConfig::RenderNPCs() {
         SaveResetRow();
     }
     FontAwesome::Pop();
+
+    Settings::PublishConfigIfChanged();
 }
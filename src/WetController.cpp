@@ -14,6 +14,11 @@
 #include "RE/T/TESObjectCELL.h"
 #include "REL/Relocation.h"
 #include "Settings.h"
+#include "utils/Classify.h"
+#include "utils/CoSave.h"
+#include "utils/InputRecorder.h"
+#include "utils/Profiler.h"
+#include "utils/WetSim.h"
 
 using namespace std::chrono_literals;
 
@@ -29,7 +34,16 @@ using namespace std::chrono_literals;
 #endif
 
 namespace SWE {
-    enum class MatCat { SkinFace, Hair, ArmorClothing, Weapon, Other };
+    using MatCat = Classify::MatCat;
+
+    // Cumulative counters for SWE_GetPerfCounters, bumped on the game thread and read from any thread
+    static std::atomic<std::uint64_t> g_perfTotal[WetController::kPerfCount]{};
+    static std::atomic<double> g_perfRate[WetController::kPerfCount]{};
+    static std::atomic<std::uint64_t> g_perfBytes[3]{};  // _wet, _matCache, external sources
+
+    static inline void PerfAdd(WetController::PerfCounter c, std::uint64_t n = 1) {
+        g_perfTotal[c].fetch_add(n, std::memory_order_relaxed);
+    }
 
     static inline float clampf(float v, float lo, float hi) { return (v < lo) ? lo : (v > hi) ? hi : v; }
 
@@ -75,21 +89,12 @@ namespace SWE {
 
         sp->SetFlags(RE::BSShaderProperty::EShaderPropertyFlag8::kSpecular, on);
     }
+    static inline std::string_view NodeName(const RE::NiAVObject* o) {
+        const char* n = o ? o->name.c_str() : nullptr;
+        return n ? n : "";
+    }
     static inline bool NameHas(const RE::NiAVObject* o, std::string_view s) {
-        if (!o) return false;
-        std::string n = o->name.c_str();
-        std::transform(n.begin(), n.end(), n.begin(), [](unsigned char c) { return std::tolower(c); });
-        std::string t(s);
-        std::transform(t.begin(), t.end(), t.begin(), [](unsigned char c) { return std::tolower(c); });
-        return n.find(t) != std::string::npos;
-    }
-    static inline std::string lc_norm_path(const char* p) {
-        if (!p || !p[0]) return {};
-        std::string s(p);
-        std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return (char)std::tolower(c); });
-        std::replace(s.begin(), s.end(), '\\', '/');
-        s.erase(std::unique(s.begin(), s.end(), [](char a, char b) { return a == '/' && b == '/'; }), s.end());
-        return s;
+        return o && Classify::ContainsCI(NodeName(o), s);
     }
     static bool HasAuxKeywords(const RE::NiAVObject* root) {
         if (!root) return false;
@@ -126,11 +131,13 @@ namespace SWE {
     static bool TexLooksLikeEye(RE::BSLightingShaderMaterialBase* mb) {
         if (!mb || !mb->textureSet) return false;
         auto hasEyes = [&](RE::BSTextureSet::Texture t) {
-            std::string p = lc_norm_path(mb->textureSet->GetTexturePath(t));
-            if (p.empty()) return false;
-            if (p.find("brow") != std::string::npos || p.find("lash") != std::string::npos) return false;
-            return p.find("/eyes/") != std::string::npos || p.find("_eye") != std::string::npos ||
-                   p.find("eyes") != std::string::npos;
+            const char* raw = mb->textureSet->GetTexturePath(t);
+            if (!raw || !raw[0]) return false;
+            const Classify::NormPath norm(raw);
+            const std::string_view p = norm.view();
+            if (p.find("brow") != std::string_view::npos || p.find("lash") != std::string_view::npos) return false;
+            return p.find("/eyes/") != std::string_view::npos || p.find("_eye") != std::string_view::npos ||
+                   p.find("eyes") != std::string_view::npos;
         };
         return hasEyes(RE::BSTextureSet::Texture::kDiffuse) || hasEyes(RE::BSTextureSet::Texture::kNormal);
     }
@@ -170,38 +177,14 @@ namespace SWE {
     static bool LooksLikeHeatSource(const RE::TESObjectREFR* r) {
         if (!r) return false;
 
-        auto lc = [](std::string s) {
-            std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
-            return s;
-        };
-
         if (auto* base = r->GetBaseObject()) {
-            if (const char* nm = base->GetName()) {
-                std::string n = lc(nm);
-                if (n.find("campfire") != std::string::npos || n.find("fireplace") != std::string::npos ||
-                    n.find("brazier") != std::string::npos || n.find("hearth") != std::string::npos ||
-                    n.find("embers") != std::string::npos || n.find("forge") != std::string::npos ||
-                    n.find("smelter") != std::string::npos)
-                    return true;
-
-                if (n.find("fire") != std::string::npos && n.find("torch") == std::string::npos &&
-                    n.find("candle") == std::string::npos)
-                    return true;
-            }
+            if (const char* nm = base->GetName(); nm && Classify::HeatSourceName(nm)) return true;
         }
 
         if (auto* root = r->Get3D()) {
             const RE::NiAVObject* cur = root;
             for (int i = 0; i < 4 && cur; ++i) {
-                if (NameHas(cur, "campfire") || NameHas(cur, "fireplace") || NameHas(cur, "brazier") ||
-                    NameHas(cur, "hearth") || NameHas(cur, "embers") || NameHas(cur, "forge") ||
-                    NameHas(cur, "smelter")) {
-                    return true;
-                }
-
-                if (NameHas(cur, "fire") && !NameHas(cur, "torch") && !NameHas(cur, "candle")) {
-                    return true;
-                }
+                if (Classify::HeatSourceName(NodeName(cur))) return true;
                 cur = cur->parent;
             }
         }
@@ -211,19 +194,9 @@ namespace SWE {
 
     static bool LooksLikeWorkFurniture(const RE::TESObjectREFR* r) {
         if (!r) return false;
-        const auto lc = [](std::string s) {
-            std::transform(s.begin(), s.end(), s.begin(), ::tolower);
-            return s;
-        };
 
         const char* ed = r->GetBaseObject() ? r->GetBaseObject()->GetFormEditorID() : nullptr;
-        std::string name = lc(ed ? ed : "");
-        const char* keys[] = {"workbench", "forge",   "smelter", "grindstone", "tanning",
-                              "alchemy",   "enchant", "cooking", "chopping",   "choppingblock",
-                              "sawmill",   "mine",    "mining",  "ore",        "blacksmith"};
-        for (auto* k : keys)
-            if (name.find(k) != std::string::npos) return true;
-        return false;
+        return ed && Classify::WorkFurnitureEditorID(ed);
     }
 
     static RE::TESObjectREFR* ToRefPtr(const RE::NiPointer<RE::TESObjectREFR>& p) { return p.get(); }
@@ -321,7 +294,7 @@ namespace SWE {
         const auto& rd = a->GetActorRuntimeData();
         return rd.boolBits.any(RE::Actor::BOOL_BITS::kInWater) || rd.boolFlags.any(RE::Actor::BOOL_FLAGS::kUnderwater);
     }
-    static inline bool IsActorWetByWater(RE::Actor* a) {
+    static inline bool IsActorWetByWater(RE::Actor* a, float minSub) {
         if (!a) return false;
         const auto& rd = a->GetActorRuntimeData();
 
@@ -332,7 +305,6 @@ namespace SWE {
         const bool hasContact = inWaterFlag || underwater || swimming;
         if (!hasContact) return false;
 
-        const float minSub = std::clamp(Settings::minSubmergeToSoak.load(), 0.0f, 0.99f);
         if (minSub <= 0.0001f) return true;
 
         float s = underwater ? 1.0f : ComputeSubmergeLevel(a);
@@ -340,81 +312,6 @@ namespace SWE {
 
         return s >= minSub;
     }
-    static bool TexLooksLikeBodySkin(RE::BSLightingShaderMaterialBase* mb) {
-        RE::BSTextureSet* ts = mb->textureSet.get();
-        if (!ts) return false;
-
-        using Tex = RE::BSTextureSet::Texture;
-        auto texPathDN = [&](int dn) -> const char* {
-            Tex slot = (dn == 0) ? Tex::kDiffuse : Tex::kNormal;
-            return ts->GetTexturePath(slot);
-        };
-
-        auto has = [&](int idx, std::string_view needle) {
-            const char* p = texPathDN(idx);
-            if (!p || !p[0]) return false;
-            std::string s(p);
-            std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
-            return s.find(needle) != std::string::npos;
-        };
-
-        const bool inActors = has(0, "actors/character") || has(1, "actors/character");
-        const bool skinish = has(0, "body") || has(1, "body") || has(0, "hand") || has(1, "hand") || has(0, "feet") ||
-                             has(1, "feet") || has(0, "skin") || has(1, "skin");
-        const bool armorish = has(0, "armor/") || has(1, "armor/") || has(0, "clothes/") || has(1, "clothes/");
-        return inActors && skinish && !armorish;
-    }
-    static bool LooksLikeBodySkin(const RE::NiAVObject* o) {
-        const RE::NiAVObject* cur = o;
-        for (int i = 0; i < 4 && cur; ++i) {
-            const bool isSkiny = NameHas(cur, "body") || NameHas(cur, "hands") || NameHas(cur, "hand") ||
-                                 NameHas(cur, "feet") || NameHas(cur, "foot") || NameHas(cur, "skin") ||
-                                 NameHas(cur, "femalebody") || NameHas(cur, "malebody");
-            const bool looksArmor = NameHas(cur, "armor") || NameHas(cur, "cuirass") || NameHas(cur, "gauntlet") ||
-                                    NameHas(cur, "glove") || NameHas(cur, "boot") || NameHas(cur, "shoe") ||
-                                    NameHas(cur, "robe");
-            if (isSkiny && !looksArmor) return true;
-            cur = cur->parent;
-        }
-        return false;
-    }
-    
-    static inline std::string_view filename_no_ext(std::string_view path) {
-        const size_t slash = path.find_last_of('/');
-        std::string_view file = (slash == std::string::npos) ? path : path.substr(slash + 1);
-        const size_t dot = file.find_last_of('.');
-        return (dot == std::string::npos) ? file : file.substr(0, dot);
-    }
-
-    static bool has_suffix_token(std::string_view path, std::string_view token) {
-        const std::string_view base = filename_no_ext(path);
-        if (base.size() < token.size()) return false;
-        const size_t pos = base.size() - token.size();
-        if (base.substr(pos) != token) return false;
-        if (pos == 0) return true;
-        const char prev = base[pos - 1];
-        return prev == '_' || prev == '-' || prev == '.';
-    }
-
-    static bool has_ambiguous_p_suffix(std::string_view path) { return has_suffix_token(path, "p"); }
-
-    static bool contains_word(std::string_view s, std::string_view w) { return s.find(w) != std::string::npos; }
-
-    static bool strong_pbr_signal(std::string_view p) {
-        if (contains_word(p, "/pbr/") || contains_word(p, "_pbr") || contains_word(p, "/pbr_")) return true;
-
-        if (has_suffix_token(p, "orm") || has_suffix_token(p, "rma") || has_suffix_token(p, "rmao") ||
-            has_suffix_token(p, "rmaos") || has_suffix_token(p, "rmos") || has_suffix_token(p, "mrao") ||
-            has_suffix_token(p, "maos"))
-            return true;
-
-        if (contains_word(p, "roughness") || contains_word(p, "rough") || contains_word(p, "metalness") ||
-            contains_word(p, "metallic") || contains_word(p, "metal"))
-            return true;
-
-        return false;
-    }
-
     // TruePBR sets kVertexLighting
     static inline bool IsTruePBR_CS(const RE::BSLightingShaderProperty* lsp) {
         if (!lsp) return false;
@@ -423,92 +320,49 @@ namespace SWE {
     static bool MaterialLooksPBR(RE::BSLightingShaderMaterialBase* mb) {
         if (!mb) return false;
         RE::BSTextureSet* ts = mb->textureSet.get();
-        auto slot = [&](RE::BSTextureSet::Texture t) -> std::string {
-            return lc_norm_path(ts ? ts->GetTexturePath(t) : nullptr);
-        };
-
-        std::string paths[6] = {
-            slot(RE::BSTextureSet::Texture::kDiffuse),         slot(RE::BSTextureSet::Texture::kNormal),
-            slot(RE::BSTextureSet::Texture::kSpecular),        slot(RE::BSTextureSet::Texture::kGlowMap),
-            slot(RE::BSTextureSet::Texture::kEnvironmentMask), slot(RE::BSTextureSet::Texture::kBacklightMask),
-        };
-
-        bool anyStrong = false;
-        bool anyAmbigP = false;
-
-        for (const auto& p : paths) {
-            if (p.empty()) continue;
-            if (strong_pbr_signal(p)) anyStrong = true;
-            if (has_ambiguous_p_suffix(p)) anyAmbigP = true;
-        }
+        if (!ts) return false;
 
-        // _p only textures are ambiguous, could be Parallax Height or could be ORM
-        return anyStrong || (anyAmbigP && anyStrong);
+        using Tex = RE::BSTextureSet::Texture;
+        const char* paths[] = {ts->GetTexturePath(Tex::kDiffuse), ts->GetTexturePath(Tex::kNormal),
+                               ts->GetTexturePath(Tex::kSpecular), ts->GetTexturePath(Tex::kGlowMap),
+                               ts->GetTexturePath(Tex::kEnvironmentMask), ts->GetTexturePath(Tex::kBacklightMask)};
+        return Classify::TexturesLookPBR(paths);
     }
     static MatCat ClassifyGeom(RE::BSGeometry* g, RE::BSLightingShaderProperty* lsp) {
-        if (lsp && lsp->material) {
-            if (auto* mb = static_cast<RE::BSLightingShaderMaterialBase*>(lsp->material)) {
-                using F = RE::BSLightingShaderMaterialBase::Feature;
-                switch (mb->GetFeature()) {
-                    case F::kFaceGen:
-                    case F::kFaceGenRGBTint:
-                        return MatCat::SkinFace;
-                    case F::kHairTint:
-                        return MatCat::Hair;
-                    default:
-                        break;
-                }
+        Classify::Geom in;
+        auto* mb = lsp ? static_cast<RE::BSLightingShaderMaterialBase*>(lsp->material) : nullptr;
+        if (mb) {
+            using F = RE::BSLightingShaderMaterialBase::Feature;
+            const F f = mb->GetFeature();
+            in.faceGen = f == F::kFaceGen || f == F::kFaceGenRGBTint;
+            in.hairTint = f == F::kHairTint;
+            if (RE::BSTextureSet* ts = mb->textureSet.get()) {
+                in.diffuse = ts->GetTexturePath(RE::BSTextureSet::Texture::kDiffuse);
+                in.normal = ts->GetTexturePath(RE::BSTextureSet::Texture::kNormal);
             }
         }
 
+        std::uint16_t slot = 0;
+        std::array<std::string_view, Classify::kGeomNames> names{};
         if (g) {
             auto& grt = g->GetGeometryRuntimeData();
-            if (auto* si = grt.skinInstance.get()) {
-                if (auto* dsi = netimmerse_cast<RE::BSDismemberSkinInstance*>(si)) {
-                    const auto& rd = dsi->GetRuntimeData();
-                    for (int i = 0; i < rd.numPartitions; ++i) {
-                        const std::uint16_t slot = rd.partitions[i].slot;
-                        switch (slot) {
-                            case 30:
-                                return MatCat::SkinFace;
-                            case 31:
-                                return MatCat::Hair;
-                            case 41:
-                                return MatCat::Weapon;
-                            case 32:
-                            case 33:
-                            case 37: {
-                                auto* mb =
-                                    lsp ? static_cast<RE::BSLightingShaderMaterialBase*>(lsp->material) : nullptr;
-                                if ((mb && TexLooksLikeBodySkin(mb)) || LooksLikeBodySkin(g)) return MatCat::SkinFace;
-                                return MatCat::ArmorClothing;
-                            }
-                            case 34:
-                            case 35:
-                            case 36:
-                            case 38:
-                            case 39:
-                            case 40:
-                                return MatCat::ArmorClothing;
-                            default:
-                                break;
-                        }
+            auto* si = grt.skinInstance.get();
+            if (auto* dsi = si ? netimmerse_cast<RE::BSDismemberSkinInstance*>(si) : nullptr) {
+                // only the first partition in the body slot range (30-41) decides, the others are skipped
+                const auto& rd = dsi->GetRuntimeData();
+                for (int i = 0; i < rd.numPartitions; ++i) {
+                    slot = rd.partitions[i].slot;
+                    if (slot >= 30 && slot <= 41) {
+                        in.slots = std::span(&slot, 1);
+                        break;
                     }
                 }
             }
+            std::size_t n = 0;
+            for (const RE::NiAVObject* cur = g; cur && n < names.size(); cur = cur->parent) names[n++] = NodeName(cur);
+            in.names = std::span(names.data(), n);
         }
-
-        const RE::NiAVObject* cur = g;
-        for (int i = 0; i < 4 && cur; ++i) {
-            if (NameHas(cur, "hair")) return MatCat::Hair;
-            if (NameHas(cur, "head") || NameHas(cur, "face")) return MatCat::SkinFace;
-            if (LooksLikeBodySkin(cur)) return MatCat::SkinFace;
-            if (NameHas(cur, "weapon") || NameHas(cur, "sword") || NameHas(cur, "bow") || NameHas(cur, "dagger"))
-                return MatCat::Weapon;
-            cur = cur->parent;
-        }
-
-        return MatCat::ArmorClothing;
+        return Classify::ClassifyGeom(in);
     }
     static inline std::uint32_t MakeFilterInfo(RE::COL_LAYER layer, std::uint16_t systemGroup = 0xFFFF,
                                                std::uint8_t subSystemId = 0, std::uint8_t subSystemNoCollide = 0) {
@@ -587,6 +441,8 @@ namespace SWE {
     static inline bool CastOnce(RE::bhkWorld* bw, const RE::NiPoint3& fromW, const RE::NiPoint3& toW,
                                 std::uint32_t filterInfo, bool enableCollectionFilter) {
         if (!bw) return false;
+        SWE_PROFILE_COUNT(Rays, 1);
+        PerfAdd(WetController::kPerfRaycasts);
 
         RE::bhkPickData pd{};
         pd.rayInput.from = ToHK(fromW);
@@ -637,6 +493,27 @@ namespace SWE {
         outMax = mx;
         return true;
     }
+    // Conservative visibility: app-culled 3D is hidden, otherwise the world bound is tested against a cone around
+    // the main camera's view direction that is wider than any sane FOV, so only clearly off-screen actors fail.
+    static bool IsRootOnScreen(const RE::NiAVObject* root, const RE::NiCamera* cam) {
+        if (!root || root->GetAppCulled()) return false;
+        if (!cam) return true;
+
+        constexpr float kHalfAngle = 1.4f;  // ~80 deg
+        const auto& wb = root->worldBound;
+        const auto& m = cam->world.rotate;
+        const RE::NiPoint3 fwd{m.entry[0][0], m.entry[1][0], m.entry[2][0]};  // NiCamera looks down its local X axis
+        const RE::NiPoint3 d = wb.center - cam->world.translate;
+
+        const float dist = d.Length();
+        if (dist <= wb.radius) return true;
+        const float along = d.Dot(fwd);
+        if (along < -wb.radius) return false;
+
+        const float angle = std::acos(std::clamp(along / dist, -1.0f, 1.0f));
+        return angle <= kHalfAngle + std::asin(std::min(1.0f, wb.radius / dist));
+    }
+
     static bool LooksLikeWaterfall(RE::TESObjectREFR* r) {
         if (!r) return false;
 
@@ -744,7 +621,20 @@ namespace SWE {
 
     void WetController::OnPreLoadGame() {
         _wet.clear();
+        _pending = {};
+        _pendingUsed = {};
+        _pendingLeft = 0;
+        _cold.clear();
+        _unlisted.clear();
         _matCache.clear();
+        _applyQueue.clear();
+        _fpCache = {};
+
+        // nobody is above any threshold in the next save until the tick says so
+        _events.clear();
+        for (const auto& s : *_subs.load(std::memory_order_acquire)) s->above.clear();
+        _modEventSub->above.clear();
+        _stateVersion.fetch_add(1, std::memory_order_release);
     }
 
     void WetController::OnPostLoadGame() { RefreshNow(); }
@@ -756,14 +646,15 @@ namespace SWE {
     float WetController::GetPlayerWetness() const {
         auto* pc = RE::PlayerCharacter::GetSingleton();
         if (!pc) return 0.f;
-        auto it = _wet.find(pc->GetFormID());
-        return (it != _wet.end()) ? it->second.wetness : 0.f;
+        if (auto it = _wet.find(pc->GetFormID()); it != _wet.end()) return it->second.wetness;
+        const CoSave::Actor* saved = FindPending(pc->GetFormID());
+        return saved ? clampf(saved->wetness, 0.f, 1.f) : 0.f;
     }
 
     void WetController::SetPlayerWetnessSnapshot(float w) {
         auto* pc = RE::PlayerCharacter::GetSingleton();
         if (!pc) return;
-        _wet[pc->GetFormID()].wetness = clampf(w, 0.f, 1.f);
+        WetOf(pc->GetFormID()).wetness = clampf(w, 0.f, 1.f);
     }
 
     bool WetController::IsRainingCurrent() const {
@@ -790,10 +681,32 @@ namespace SWE {
     }
 
 
+    void WetController::BuildWorldContext(const Settings::Config& cfg) {
+        WorldContext& w = _world;
+        w.now = std::chrono::steady_clock::now();
+        w.gameHours = GetGameHours();
+
+        auto* ui = RE::UI::GetSingleton();
+        w.paused = ui && (ui->GameIsPaused() || ui->IsMenuOpen(RE::MainMenu::MENU_NAME));
+
+        w.rain = cfg.rainEnabled && IsRainingCurrent();
+        w.snow = cfg.snowEnabled && IsSnowingCurrent();
+
+        // four menu lookups by name, only when the "working" activity trigger can use them
+        w.craftingMenu = false;
+        if (ui && !w.paused && cfg.activityWetEnabled && cfg.activityTriggerWorking) {
+            w.craftingMenu = ui->IsMenuOpen("Crafting Menu") || ui->IsMenuOpen("Alchemy Menu") ||
+                             ui->IsMenuOpen("Enchanting Menu") || ui->IsMenuOpen("Cooking Menu");
+        }
+    }
+
     void WetController::TickGameThread() {
-        if (!Settings::modEnabled.load() || !_running.load()) return;
+        _cfg = Settings::GetConfig();
+        const Settings::Config& cfg = *_cfg;
+        if (!cfg.modEnabled || !_running.load()) return;
 
-        float ghNow = GetGameHours();
+        BuildWorldContext(cfg);
+        float ghNow = _world.gameHours;
         if (!_hasLastGameHours) {
             _lastGameHours = ghNow;
             _hasLastGameHours = true;
@@ -804,15 +717,11 @@ namespace SWE {
         float ghDeltaSec = ghDelta * 3600.0f;
         _lastGameHours = ghNow;
 
-        const auto now = std::chrono::steady_clock::now();
-        const auto wantDelta = std::chrono::milliseconds(std::max(10, Settings::updateIntervalMs.load()));
+        const auto now = _world.now;
+        const auto wantDelta = std::chrono::milliseconds(cfg.tickIntervalMs);
         const auto elapsed = now - _lastTick;
         if (elapsed < wantDelta) {
-            if (auto* ui0 = RE::UI::GetSingleton()) {
-                if (ui0->GameIsPaused() || ui0->IsMenuOpen(RE::MainMenu::MENU_NAME)) {
-                    _carrySkipSec += ghDeltaSec;
-                }
-            }
+            if (_world.paused) _carrySkipSec += ghDeltaSec;
             return;
         }
 
@@ -820,104 +729,50 @@ namespace SWE {
         _lastTick = now;
         dt = clampf(dt, 0.0f, 0.2f);
 
-        if (auto* ui = RE::UI::GetSingleton()) {
-            if (ui->GameIsPaused() || ui->IsMenuOpen(RE::MainMenu::MENU_NAME)) {
-                _carrySkipSec += ghDeltaSec;
-                return;
-            }
+        if (_world.paused) {
+            _carrySkipSec += ghDeltaSec;
+            return;
         }
 
+        SWE_PROFILE_SCOPE(Tick);
+        PerfAdd(kPerfTicks);
+
         double effDt = static_cast<double>(dt) + _carrySkipSec + static_cast<double>(ghDeltaSec);
         _carrySkipSec = 0.0;
+        _simClock.store(_simClock.load(std::memory_order_relaxed) + effDt, std::memory_order_release);
 
-        const auto overridesSnap = Settings::SnapshotActorOverrides();
-        const auto trackedSnap = Settings::SnapshotTrackedActors();
+        // A regular tick covers its real interval plus the game time passing meanwhile
+        const auto* cal = RE::Calendar::GetSingleton();
+        const float timescale = cal ? std::max(0.f, cal->GetTimescale()) : 20.f;
+        const float stepDt = static_cast<float>(cfg.tickIntervalMs) / 1000.f * (1.f + timescale);
+        _stepDt.store(stepDt, std::memory_order_relaxed);
 
-        std::unordered_set<std::uint32_t> allow;
-        const bool optIn = Settings::npcOptInOnly.load();
-        std::unordered_set<std::uint32_t> allowIDs;
-
-        if (optIn) {
-            for (const auto& fs : trackedSnap)
-                if (fs.enabled && fs.id) allowIDs.insert(fs.id);
-            for (const auto& fs : overridesSnap)
-                if (fs.enabled && fs.id) allowIDs.insert(fs.id);
-        }
-
-        auto local_id = [](std::uint32_t id) -> std::uint32_t {
-            return ((id >> 24) == 0xFEu) ? (id & 0x00000FFFu) : (id & 0x00FFFFFFu);
-        };
-
-        auto same_local = [&](std::uint32_t a, std::uint32_t b) -> bool {
-            if (!a || !b) return false;
-            return local_id(a) == local_id(b);
-        };
-
-        auto lower = [](std::string s) {
-            std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return (char)std::tolower(c); });
-            return s;
-        };
-
-        auto get_base_plugin = [](RE::Actor* a) -> std::string {
-            if (!a) return {};
-            if (auto* ab = a->GetActorBase()) {
-                if (auto* f = ab->GetFile(0)) {
-                    return to_string_compat(f->GetFilename());
-                }
-            }
-            return {};
-        };
-
-        auto isAllowed = [&](RE::Actor* a) -> bool {
-            if (!optIn || !a) return true;
-
-            const std::uint32_t refID = a->GetFormID();
-            const std::uint32_t baseID = (a->GetActorBase() ? a->GetActorBase()->GetFormID() : 0);
-
-            if (allowIDs.count(refID) || allowIDs.count(baseID)) return true;
-
-            // ESL safe check
-            const std::string plugin = lower(get_base_plugin(a));
-            if (!plugin.empty()) {
-                auto matches = [&](const Settings::FormSpec& fs) {
-                    if (!fs.enabled || !fs.id || fs.plugin.empty()) return false;
-                    if (lower(fs.plugin) != plugin) return false;
-                    return same_local(fs.id, baseID) || same_local(fs.id, refID);
-                };
-                if (std::any_of(trackedSnap.begin(), trackedSnap.end(), matches)) return true;
-                if (std::any_of(overridesSnap.begin(), overridesSnap.end(), matches)) return true;
-            }
-
-            return false;
-        };
+        // Shared, immutable copy of the actor lists; republished by the menu on edit, so nothing is copied here
+        const auto lists = Settings::GetActorListsSnapshot();
+        const bool optIn = cfg.npcOptInOnly;
 
+        // both are only written when their version changed since the last tick
+        Rec::Config(cfg);
+        Rec::ActorLists(*lists);
+        Rec::Tick(static_cast<float>(effDt), ghDeltaSec, stepDt);
 
         RE::Actor* player = RE::PlayerCharacter::GetSingleton();
-        if (player) UpdateActorWetness(player, static_cast<float>(effDt), overridesSnap, true);
+        if (player) {
+            UpdateActorWetness(player, static_cast<float>(effDt), *lists, true);
+
+            const auto* cam = RE::PlayerCamera::GetSingleton();
+            const bool firstPerson = cam && cam->IsInFirstPerson();
+            if (firstPerson != _lastFirstPerson) {
+                // the skeleton that just became visible still shows whatever it had when it was last active
+                _lastFirstPerson = firstPerson;
+                QueueApply(player, WetOf(player->GetFormID()).lastAppliedCat);
+            }
+        }
 
-        if (Settings::affectNPCs.load()) {
+        if (cfg.affectNPCs) {
             if (auto* proc = RE::ProcessLists::GetSingleton()) {
 
-                std::unordered_set<std::uint32_t> allow;
-                const bool optIn = Settings::npcOptInOnly.load();
-                if (optIn) {
-                    for (const auto& fs : trackedSnap)
-                        if (fs.enabled && fs.id) allowIDs.insert(fs.id);
-                    for (const auto& fs : overridesSnap)
-                        if (fs.enabled && fs.id) allowIDs.insert(fs.id);
-                }
-
-                auto resolveAutoWet = [&](RE::Actor* a) -> bool {
-                    const std::uint32_t refID = a->GetFormID();
-                    const std::uint32_t baseID = (a->GetActorBase() ? a->GetActorBase()->GetFormID() : 0);
-                    for (const auto& fs : trackedSnap) {
-                        if (!fs.id) continue;
-                        if ((fs.id == refID) || (fs.id == baseID)) return fs.autoWet;
-                    }
-                    return true;  // default Automatic
-                };
-
-                const int radius = Settings::npcRadius.load();
+                const int radius = cfg.npcRadius;
                 const bool useRad = (radius > 0);
                 const float radiusSq = static_cast<float>(radius) * static_cast<float>(radius);
                 const RE::NiPoint3 pcPos = player ? player->GetPosition() : RE::NiPoint3();
@@ -927,75 +782,372 @@ namespace SWE {
                     if (!a || a == player) continue;
 
                     const std::uint32_t refID = a->GetFormID();
-                    const std::uint32_t baseID = (a->GetActorBase() ? a->GetActorBase()->GetFormID() : 0);
-                    const bool selected = isAllowed(a);
+                    // actors seen before reuse their cached policy, new ones are resolved without creating state
+                    WetData* known = FindWet(refID);
+                    const ActorPolicy policy = [&] {
+                        SWE_PROFILE_SCOPE(AllowList);
+                        return known ? PolicyFor(*known, a, *lists) : PolicyForUnknown(a, *lists);
+                    }();
+                    const bool selected = !optIn || policy.listed;
 
                     if (useRad && player) {
                         const float d2 = a->GetPosition().GetSquaredDistance(pcPos);
                         if (d2 > radiusSq) {
-                            auto it = _wet.find(refID);
-                            if (it != _wet.end() &&
-                                (it->second.lastAppliedWet > 0.0005f || it->second.wetness > 0.0005f)) {
-                                const float zeros[4]{0, 0, 0, 0};
-                                ApplyWetnessMaterials(a, zeros);
-                                it->second.wetness = 0.0f;
-                                it->second.lastAppliedWet = 0.0f;
-                                it->second.lastAppliedCat[0] = it->second.lastAppliedCat[1] =
-                                    it->second.lastAppliedCat[2] = it->second.lastAppliedCat[3] = 0.0f;
-                                it->second.extSources.clear();
-                            }
+                            // Not simulated out here: its state stays as it was and is advanced in closed form
+                            // when it comes back in range. Still loaded, so it is not a candidate for the cold tier.
+                            if (known) known->lastSeen = now;
+                            PerfAdd(kPerfActorsSkipped);
                             continue;
                         }
                     }
 
                     if (!selected) {
-                        auto it = _wet.find(refID);
-                        if (it != _wet.end() && (it->second.lastAppliedWet > 0.0005f || it->second.wetness > 0.0005f)) {
+                        if (known && (known->lastAppliedWet > 0.0005f || known->wetness > 0.0005f)) {
                             const float zeros[4]{0, 0, 0, 0};
-                            ApplyWetnessMaterials(a, zeros);
-                            it->second.wetness = 0.0f;
-                            it->second.lastAppliedWet = 0.0f;
-                            it->second.lastAppliedCat[0] = it->second.lastAppliedCat[1] = it->second.lastAppliedCat[2] =
-                                it->second.lastAppliedCat[3] = 0.0f;
-                            it->second.extSources.clear();
+                            QueueApply(a, zeros);
+                            NoteWetness(a, known->wetness, 0.0f);
+                            known->wetness = 0.0f;
+                            known->lastAppliedWet = 0.0f;
+                            known->lastAppliedCat[0] = known->lastAppliedCat[1] = known->lastAppliedCat[2] =
+                                known->lastAppliedCat[3] = 0.0f;
+                            known->extSources.clear();
+                            Rec::Deselect(refID);
                         }
+                        PerfAdd(kPerfActorsSkipped);
                         continue;
                     }
 
-                    const bool autoWet = resolveAutoWet(a);
+                    const bool autoWet = policy.autoWet;
                     const bool manualMode = !autoWet;
                     const bool allowEnvWet = autoWet;
 
-                    UpdateActorWetness(a, static_cast<float>(effDt), overridesSnap, allowEnvWet, manualMode);
+                    UpdateActorWetness(a, static_cast<float>(effDt), *lists, allowEnvWet, manualMode);
                 }
             }
         }
+
+        DrainApplyQueue();
+        DispatchWetnessEvents();
+        PublishSharedTable();
+        UpdateTiers(now);
+        UpdatePerfWindow(now);
+        SWE_PROFILE_DUMP();
     }
 
-    void WetController::UpdateActorWetness(RE::Actor* a, float dt, const std::vector<Settings::FormSpec>& overrides, bool allowEnvWet, bool manualMode) {
-        if (!a) return;
+    void WetController::UpdatePerfWindow(std::chrono::steady_clock::time_point now) {
+        if (_perfWindowStart.time_since_epoch().count() == 0) {
+            _perfWindowStart = now;
+            for (int i = 0; i < kPerfCount; ++i) _perfWindowBase[i] = g_perfTotal[i].load(std::memory_order_relaxed);
+            return;
+        }
+        const double secs = std::chrono::duration<double>(now - _perfWindowStart).count();
+        if (secs < 1.0) return;
+
+        for (int i = 0; i < kPerfCount; ++i) {
+            const std::uint64_t total = g_perfTotal[i].load(std::memory_order_relaxed);
+            g_perfRate[i].store(static_cast<double>(total - _perfWindowBase[i]) / secs, std::memory_order_relaxed);
+            _perfWindowBase[i] = total;
+        }
+        _perfWindowStart = now;
+
+        // Approximate heap footprint: nodes, bucket arrays and out-of-line strings/vectors. API threads insert
+        // into _wet and the source maps under the lock, so the walk takes it too.
+        std::scoped_lock l(_mtx);
+        constexpr std::size_t kNode = 2 * sizeof(void*);
+        std::size_t wetBytes = _wet.bucket_count() * sizeof(void*);
+        std::size_t srcBytes = 0;
+        for (const auto& [id, wd] : _wet) {
+            wetBytes += sizeof(std::pair<const std::uint32_t, WetData>) + kNode;
+            for (const auto& v : wd.geomIndex.byCat) wetBytes += v.capacity() * sizeof(GeomBinding);
+            wetBytes += wd.geomIndex.eyes.capacity() * sizeof(GeomBinding);
+
+            srcBytes += wd.extSources.bucket_count() * sizeof(void*);
+            for (const auto& [key, src] : wd.extSources) {
+                srcBytes += sizeof(std::pair<const std::string, ExternalSource>) + kNode;
+                if (key.capacity() >= sizeof(std::string)) srcBytes += key.capacity() + 1;
+            }
+        }
+        wetBytes += _cold.capacity() * sizeof(ColdActor);
+        wetBytes += _unlisted.bucket_count() * sizeof(void*) + _unlisted.size() * (2 * sizeof(std::uint32_t) + kNode);
+        wetBytes += _pending.actors.capacity() * sizeof(CoSave::Actor) +
+                    _pending.sources.capacity() * sizeof(CoSave::Source) + _pendingUsed.capacity() / 8;
+        for (const auto& k : _pending.keys) wetBytes += sizeof(std::string) + k.capacity();
+        const std::size_t matBytes = _matCache.bucket_count() * sizeof(void*) +
+                                     _matCache.size() * (sizeof(decltype(_matCache)::value_type) + kNode);
+
+        g_perfBytes[0].store(wetBytes, std::memory_order_relaxed);
+        g_perfBytes[1].store(matBytes, std::memory_order_relaxed);
+        g_perfBytes[2].store(srcBytes, std::memory_order_relaxed);
+    }
+
+    static std::uint32_t SteadySeconds(std::chrono::steady_clock::time_point t) {
+        using std::chrono::duration_cast, std::chrono::seconds;
+        return static_cast<std::uint32_t>(duration_cast<seconds>(t.time_since_epoch()).count());
+    }
+
+    void WetController::UpdateTiers(std::chrono::steady_clock::time_point now) {
+        constexpr auto kPassInterval = 2s;
+        constexpr auto kColdAfter = 10s;  // unseen this long counts as unloaded
+        if (now - _lastTierPass < kPassInterval) return;
+        _lastTierPass = now;
+
+        const Settings::Config& cfg = *_cfg;
+        const std::uint32_t nowSec = SteadySeconds(now);
+        const auto* player = RE::PlayerCharacter::GetSingleton();
+        const std::uint32_t playerID = player ? player->GetFormID() : 0;
+
+        std::scoped_lock l(_mtx);
+
+        // Only actors whose whole state is the simulated wetness can go cold; external sources (other than the
+        // activity one, which decays anyway) keep an actor hot so mods see them unchanged.
+        std::vector<ColdActor> frozen;
+        for (auto it = _wet.begin(); it != _wet.end();) {
+            const WetData& wd = it->second;
+            const bool onlyActivity =
+                std::ranges::all_of(wd.extSources, [](const auto& kv) { return kv.first == "__activity"; });
+            const bool idle = it->first != playerID && now - wd.lastSeen > kColdAfter &&
+                              !_applyQueue.contains(it->first) && onlyActivity;
+            if (!idle) {
+                ++it;
+                continue;
+            }
+
+            // recency is when the actor was last seen, not when it went cold: age eviction and save ranking use it
+            ColdActor c{it->first, {}, SteadySeconds(wd.lastSeen)};
+            c.simSec = static_cast<std::uint32_t>(std::max(0.0, wd.simTime < 0.0 ? _simClock.load() : wd.simTime));
+            c.env = static_cast<std::uint32_t>(wd.envClass);
+            bool wet = false;
+            for (int ci = 0; ci < 4; ++ci) {
+                const float w = clampf(wd.simInit ? wd.simCat[ci] : wd.wetness, 0.f, 1.f);
+                c.cat[ci] = static_cast<std::uint8_t>(std::lround(w * 255.f));
+                wet |= c.cat[ci] != 0;
+            }
+            if (wet) frozen.push_back(c);
+            it = _wet.erase(it);
+        }
+        if (!frozen.empty()) {
+            std::ranges::sort(frozen, {}, &ColdActor::formID);
+            const auto mid = _cold.insert(_cold.end(), frozen.begin(), frozen.end());
+            std::inplace_merge(_cold.begin(), mid, _cold.end(),
+                               [](const ColdActor& a, const ColdActor& b) { return a.formID < b.formID; });
+        }
 
-        auto getOverride = [&](float& outW, std::uint8_t& outMask) -> bool {
-            if (!manualMode) return false;
-            const std::uint32_t refID = a->GetFormID();
-            const std::uint32_t baseID = (a->GetActorBase() ? a->GetActorBase()->GetFormID() : 0);
-            for (const auto& fs : overrides) {
-                if (!fs.enabled || fs.id == 0) continue;
-                if (fs.id == refID || fs.id == baseID) {
-                    outW = clampf(fs.value, 0.f, 1.f);
-                    outMask = (fs.mask & 0x0F);
-                    return true;
+        if (cfg.coldMaxAgeMin > 0) {
+            const std::uint32_t maxAge = static_cast<std::uint32_t>(cfg.coldMaxAgeMin) * 60u;
+            std::erase_if(_cold, [&](const ColdActor& c) { return nowSec - c.lastSeenSec > maxAge; });
+        }
+        if (cfg.coldMaxActors > 0 && _cold.size() > static_cast<std::size_t>(cfg.coldMaxActors)) {
+            // keep the most recently seen, then restore the FormID order
+            const auto keep = _cold.begin() + cfg.coldMaxActors;
+            std::ranges::nth_element(_cold, keep, std::ranges::greater{}, &ColdActor::lastSeenSec);
+            _cold.resize(static_cast<std::size_t>(cfg.coldMaxActors));
+            std::ranges::sort(_cold, {}, &ColdActor::formID);
+        }
+    }
+
+    void WetController::GetPerfCounters(PerfCounters& out) const {
+        out.version = PerfCounters::kVersion;
+        for (int i = 0; i < kPerfCount; ++i) {
+            out.total[i] = g_perfTotal[i].load(std::memory_order_relaxed);
+            out.perSecond[i] = g_perfRate[i].load(std::memory_order_relaxed);
+        }
+        out.bytesWetData = g_perfBytes[0].load(std::memory_order_relaxed);
+        out.bytesMatCache = g_perfBytes[1].load(std::memory_order_relaxed);
+        out.bytesSources = g_perfBytes[2].load(std::memory_order_relaxed);
+    }
+
+    RE::NiAVObject* WetController::GetFirstPersonRoot(RE::NiAVObject* third) {
+        auto& c = _fpCache;
+        const auto now = std::chrono::steady_clock::now();
+        if (c.third == third) {
+            if (c.first) {
+                // the cached node is only trusted while it is still attached below the same root
+                for (const RE::NiNode* p = c.first->parent; p; p = p->parent) {
+                    if (p == third) return c.first.get();
                 }
+            } else if ((now - c.lastSearch) < 2s) {
+                return nullptr;
             }
-            return false;
+        }
+
+        RE::NiAVObject* first = nullptr;
+        if (third) {
+            first = third->GetObjectByName("1st Person");
+            if (!first) first = third->GetObjectByName("1stPerson");
+        }
+        c.third = third;
+        c.first.reset(first);
+        c.lastSearch = now;
+        return first;
+    }
+
+    void WetController::ResolveRenderRoots(RE::Actor* a, RE::NiAVObject* out[2]) {
+        out[0] = out[1] = nullptr;
+        RE::NiAVObject* third = a ? a->Get3D() : nullptr;
+        if (!third || !a->IsPlayerRef()) {
+            out[0] = third;
+            return;
+        }
+
+        // Only one of the player's skeletons is rendered, the other one is synced when the camera switches
+        RE::NiAVObject* first = GetFirstPersonRoot(third);
+        const auto* cam = RE::PlayerCamera::GetSingleton();
+        if (first && cam && cam->IsInFirstPerson()) {
+            out[1] = first;
+        } else {
+            out[0] = third;
+        }
+    }
+
+    void WetController::QueueApply(RE::Actor* a, const float wetByCat[4], std::uint8_t catMask) {
+        if (!a || !catMask) return;
+
+        // Coalesce with a pending job: the newest values win, the category masks accumulate
+        auto& job = _applyQueue[a->GetFormID()];
+        job.handle = a->GetHandle();
+        std::copy(wetByCat, wetByCat + 4, job.wetByCat);
+        job.catMask |= catMask;
+    }
+
+    void WetController::DrainApplyQueue() {
+        if (_applyQueue.empty()) return;
+
+        RE::NiPoint3 eye{};
+        if (auto* cam = RE::PlayerCamera::GetSingleton(); cam && cam->cameraRoot) {
+            eye = cam->cameraRoot->world.translate;
+        } else if (auto* pc = RE::PlayerCharacter::GetSingleton()) {
+            eye = pc->GetPosition();
+        }
+
+        const bool gateOffscreen = _cfg->deferOffscreenApplies;
+        const RE::NiCamera* mainCam = gateOffscreen ? RE::Main::WorldRootCamera() : nullptr;
+
+        struct Entry {
+            std::uint32_t id;
+            RE::Actor* actor;
+            int tier;  // 0=Player, 1=deferred actor that became visible, 2=Follower, 3=Other
+            float distSq;
         };
+        std::vector<Entry> order;
+        order.reserve(_applyQueue.size());
+
+        for (auto it = _applyQueue.begin(); it != _applyQueue.end();) {
+            RE::Actor* a = it->second.handle.get().get();
+            if (!a || !a->Get3D()) {
+                // unloaded, the geometry stamp forces a full apply once the 3D is back
+                it = _applyQueue.erase(it);
+                continue;
+            }
+            const bool isPlayer = a->IsPlayerRef();
+            if (gateOffscreen && !isPlayer && !IsRootOnScreen(a->Get3D(), mainCam)) {
+                // keep accumulating, the latest state is flushed as soon as the actor is seen again
+                it->second.deferred = true;
+                ++it;
+                continue;
+            }
+            const int tier = isPlayer ? 0 : it->second.deferred ? 1 : a->IsPlayerTeammate() ? 2 : 3;
+            order.push_back({it->first, a, tier, a->GetPosition().GetSquaredDistance(eye)});
+            ++it;
+        }
 
-        auto& wd = _wet[a->GetFormID()];
-        wd.lastSeen = std::chrono::steady_clock::now();
+        std::sort(order.begin(), order.end(), [](const Entry& l, const Entry& r) {
+            return (l.tier != r.tier) ? (l.tier < r.tier) : (l.distSq < r.distSq);
+        });
+
+        const int cap = _cfg->maxGeomAppliesPerTick;
+        int spent = 0;
+        for (const auto& e : order) {
+            // the player and actors that just came back on screen are flushed outside the budget, they are the
+            // ones the camera is looking at with stale materials; the rest drains over the next ticks
+            if (cap > 0 && spent >= cap && e.tier > 1) break;
+
+            auto it = _applyQueue.find(e.id);
+            const PendingApply job = it->second;
+            _applyQueue.erase(it);
+
+            std::uint8_t applied = 0;
+            {
+                SWE_PROFILE_ACTOR_SCOPE(ApplyMaterials, e.id);
+                applied = ApplyWetnessMaterials(e.actor, job.wetByCat, job.catMask);
+            }
+            // the actor may have been dropped meanwhile; API threads look up and insert under the lock
+            std::scoped_lock l(_mtx);
+            const auto wit = _wet.find(e.id);
+            if (wit == _wet.end()) continue;
+            const auto& idx = wit->second.geomIndex;
+            for (int ci = 0; ci < 4; ++ci) {
+                if (applied & (1u << ci)) spent += static_cast<int>(idx.byCat[ci].size());
+            }
+        }
+    }
+
+    WetController::ActorPolicy WetController::ResolvePolicy(RE::Actor* a, const Settings::ActorListsSnapshot& lists) {
+        ActorPolicy p;
+        p.valid = true;
+        p.listsVersion = lists.version;
+        p.baseID = (a->GetActorBase() ? a->GetActorBase()->GetFormID() : 0);
+
+        const Sim::Policy sp = Sim::ResolvePolicy(lists, a->GetFormID(), p.baseID);
+        p.listed = sp.listed;
+        p.autoWet = sp.autoWet;
+        p.hasOverride = sp.hasOverride;
+        p.forcedWet = sp.forcedWet;
+        p.forcedMask = sp.forcedMask;
+        return p;
+    }
+
+    const WetController::ActorPolicy& WetController::PolicyFor(WetData& wd, RE::Actor* a,
+                                                               const Settings::ActorListsSnapshot& lists) {
+        const std::uint32_t baseID = (a->GetActorBase() ? a->GetActorBase()->GetFormID() : 0);
+        if (!wd.policy.valid || wd.policy.listsVersion != lists.version || wd.policy.baseID != baseID)
+            wd.policy = ResolvePolicy(a, lists);
+        return wd.policy;
+    }
+
+    WetController::ActorPolicy WetController::PolicyForUnknown(RE::Actor* a,
+                                                               const Settings::ActorListsSnapshot& lists) {
+        constexpr std::size_t kMaxUnlisted = 4096;  // a few cells' worth of NPCs, then it starts over
+        if (_unlistedVersion != lists.version || _unlisted.size() >= kMaxUnlisted) {
+            _unlisted.clear();
+            _unlistedVersion = lists.version;
+        }
+
+        const std::uint32_t refID = a->GetFormID();
+        const std::uint32_t baseID = (a->GetActorBase() ? a->GetActorBase()->GetFormID() : 0);
+        if (auto it = _unlisted.find(refID); it != _unlisted.end() && it->second == baseID) {
+            ActorPolicy p;  // the defaults are what ResolvePolicy returns for an actor no list mentions
+            p.valid = true;
+            p.listsVersion = lists.version;
+            p.baseID = baseID;
+            return p;
+        }
+
+        ActorPolicy p = ResolvePolicy(a, lists);
+        if (!p.listed && p.autoWet && !p.hasOverride) _unlisted[refID] = baseID;
+        return p;
+    }
 
-        const bool inWater = allowEnvWet && IsActorWetByWater(a);
-        const bool precipRain = allowEnvWet && Settings::rainEnabled.load() && IsRainingCurrent();
-        const bool precipSnow = allowEnvWet && Settings::snowEnabled.load() && IsSnowingCurrent();
+    void WetController::UpdateActorWetness(RE::Actor* a, float dt, const Settings::ActorListsSnapshot& lists, bool allowEnvWet, bool manualMode) {
+        if (!a) return;
+        SWE_PROFILE_ACTOR_SCOPE(UpdateActor, a->GetFormID());
+        PerfAdd(kPerfActorsUpdated);
+
+        const Settings::Config& cfg = *_cfg;
+        auto& wd = WetOf(a->GetFormID());
+        wd.lastSeen = _world.now;
+        const ActorPolicy& policy = PolicyFor(wd, a, lists);
+
+        // An actor that missed ticks (out of range, just thawed) first catches up in the environment it was last in
+        const double clock = _simClock.load(std::memory_order_relaxed);
+        if (Rec::IsRecording() && wd.recSession != Rec::Session()) RecordState(a->GetFormID(), wd, clock);
+        Settle(wd, clock - dt);
+
+        const bool inWater = [&] {
+            SWE_PROFILE_SCOPE(ProbeWater);
+            return allowEnvWet && SWE::IsActorWetByWater(a, cfg.minSubmerge);
+        }();
+        const bool precipRain = allowEnvWet && _world.rain;
+        const bool precipSnow = allowEnvWet && _world.snow;
         const bool precipNow = (precipRain || precipSnow);
 
         bool isInterior = false;
@@ -1005,46 +1157,51 @@ namespace SWE {
         // If it is precipitating outside and we are in an exterior, probe roof cover
         bool inPrecipOnActor = false;
         if (precipNow && !isInterior) {
-            const auto tnow = std::chrono::steady_clock::now();
+            const auto tnow = _world.now;
             if (wd.lastRoofProbe.time_since_epoch().count() == 0 || (tnow - wd.lastRoofProbe) > 800ms) {
-                wd.lastRoofCovered = IsUnderRoof(a);
+                SWE_PROFILE_SCOPE(ProbeRoof);
+                wd.lastRoofCovered = RoofCovers(a);
                 wd.lastRoofProbe = tnow;
             }
             inPrecipOnActor = !wd.lastRoofCovered;
         }
 
-        const float soakWaterRate =
-            (Settings::secondsToSoakWater.load() > 0.01f) ? (1.f / Settings::secondsToSoakWater.load()) : 1.0f;
-        const float soakRainRate =
-            (Settings::secondsToSoakRain.load() > 0.01f) ? (1.f / Settings::secondsToSoakRain.load()) : 1.0f;
-        const float soakSnowRate =
-            (Settings::secondsToSoakSnow.load() > 0.01f) ? (1.f / Settings::secondsToSoakSnow.load()) : 1.0f;
-        const float soakWaterfallRate =
-            (Settings::secondsToSoakWaterfall.load() > 0.01f) ? (1.f / Settings::secondsToSoakWaterfall.load()) : 1.0f;
-
-
-        float dryMul = 1.0f;
-        if (!inWater) {
-            const auto now = std::chrono::steady_clock::now();
+        // Heat only speeds drying: nothing to probe in water, or for a manual actor that has nothing to dry
+        const bool probeHeat = !inWater && (allowEnvWet || wd.wetness > Sim::kDryWetness);
+        if (probeHeat) {
+            const auto now = _world.now;
             if (wd.lastHeatProbe.time_since_epoch().count() == 0 || (now - wd.lastHeatProbe) > 1s) {
-                wd.cachedNearHeat = IsNearHeatSource(a, std::max(50.0f, Settings::nearFireRadius.load()));
+                SWE_PROFILE_SCOPE(ProbeHeat);
+                wd.cachedNearHeat = IsNearHeatSource(a, cfg.heatRadius);
                 wd.lastHeatProbe = now;
             }
-            if (wd.cachedNearHeat && !inPrecipOnActor) {
-                dryMul = std::max(1.0f, Settings::dryMultiplierNearFire.load());
-            }
+        }
+        // What GetEnvMask serves until the next update; with env wetting off nothing was probed, callers recompute
+        if (allowEnvWet) {
+            std::uint8_t env = 0;
+            if (inWater) env |= SWE::Papyrus::SWE_ENV_WATER;
+            if (precipNow && !(isInterior && cfg.ignoreInterior)) env |= SWE::Papyrus::SWE_ENV_WET_WEATHER;
+            if (probeHeat && wd.cachedNearHeat) env |= SWE::Papyrus::SWE_ENV_NEAR_HEAT;
+            if (precipNow && (isInterior || wd.lastRoofCovered)) env |= SWE::Papyrus::SWE_ENV_UNDER_ROOF;
+            if (inPrecipOnActor) env |= SWE::Papyrus::SWE_ENV_EXTERIOR_OPEN;
+            std::scoped_lock l(_mtx);  // GetEnvMask reads these and stores its own probes from API threads
+            wd.envMask = env;
+            wd.envMaskAt = _world.now;
+            wd.envHeatLazy = inWater;
         }
 
         bool nearWaterfall = false;
-        if (allowEnvWet && !inWater && Settings::waterfallEnabled.load()) {
-            const auto now = std::chrono::steady_clock::now();
+        if (allowEnvWet && !inWater && cfg.waterfallEnabled) {
+            const auto now = _world.now;
             if (wd.lastWaterfallProbe.time_since_epoch().count() == 0 || (now - wd.lastWaterfallProbe) > 800ms) {
-                // const float r2 = Settings::nearWaterfallRadius.load() * Settings::nearWaterfallRadius.load();
+                SWE_PROFILE_SCOPE(ProbeWaterfall);
                 bool found = false;
                 if (auto* cell = a->GetParentCell()) {
                     const RE::NiPoint3 center = a->GetPosition();
                     cell->ForEachReference([&](RE::TESObjectREFR& ref) {
                         if (found) return RE::BSContainer::ForEachResult::kStop;
+                        SWE_PROFILE_COUNT(Refs, 1);
+                        PerfAdd(kPerfRefsScanned);
                         if (&ref == a) return RE::BSContainer::ForEachResult::kContinue;
 
                         RE::NiPoint3 bmin{}, bmax{};
@@ -1076,11 +1233,9 @@ namespace SWE {
                             dzAbs = std::abs(rp.z - center.z);
                         }
 
-                        const float r2xy = Settings::nearWaterfallRadius.load() * Settings::nearWaterfallRadius.load();
-                        if (d2xy > r2xy) return RE::BSContainer::ForEachResult::kContinue;
+                        if (d2xy > cfg.waterfallRadiusSq) return RE::BSContainer::ForEachResult::kContinue;
 
-                        if (dzAbs > std::max(1200.f, Settings::nearWaterfallRadius.load() * 1.5f))
-                            return RE::BSContainer::ForEachResult::kContinue;
+                        if (dzAbs > cfg.waterfallMaxDz) return RE::BSContainer::ForEachResult::kContinue;
 
                         bool plausible = LooksLikeWaterfall(&ref);
 
@@ -1114,9 +1269,8 @@ namespace SWE {
                         }
 
                         const bool inside =
-                            IsInsideWaterfallFX(a, &ref, std::max(0.f, Settings::waterfallWidthPad.load()),
-                                                std::max(0.f, Settings::waterfallDepthPad.load()),
-                                                std::max(0.f, Settings::waterfallZPad.load()), requireBelowTop);
+                            IsInsideWaterfallFX(a, &ref, cfg.waterfallPad[0], cfg.waterfallPad[1],
+                                                cfg.waterfallPad[2], requireBelowTop);
 
 #if SWE_WF_DEBUG
                         if (inside) {
@@ -1137,373 +1291,313 @@ namespace SWE {
             nearWaterfall = wd.cachedInsideWaterfall;
         }
 
-        float wPrevMax = std::max(std::max(wd.lastAppliedCat[0], wd.lastAppliedCat[1]),
-                                  std::max(wd.lastAppliedCat[2], wd.lastAppliedCat[3]));
-        float w = std::max(wd.wetness, wPrevMax);
-
-        const bool envDominates = allowEnvWet && (inWater || nearWaterfall || inPrecipOnActor);
-
-        if (inWater) {
-            w += soakWaterRate * dt;
-        } else if (nearWaterfall) {
-            w += soakWaterfallRate * dt;
-        } else if (inPrecipOnActor) {
-            float inc = 0.0f;
-            if (precipRain) inc = std::max(inc, soakRainRate * dt);
-            if (precipSnow) inc = std::max(inc, soakSnowRate * dt);
-            w += inc;
+        std::uint8_t actFlags = 0;
+        if (cfg.activityWetEnabled && cfg.activityMask != 0) {
+            if (cfg.activityTriggerRunning && a->IsRunning() && !inWater) actFlags |= Rec::kActRun;
+            if (cfg.activityTriggerSneaking && a->IsSneaking() && !inWater) actFlags |= Rec::kActSneak;
+            if (cfg.activityTriggerWorking) {
+                bool working = IsActorWorkingFurniture(a) && !inWater;
+                if (!working && a->IsPlayerRef()) working = _world.craftingMenu;
+                if (working) actFlags |= Rec::kActWork;
+            }
         }
 
+        Sim::ActorInput in;
+        in.clock = clock;
+        in.dt = dt;
+        in.step = _stepDt.load(std::memory_order_relaxed);
+        in.allowEnvWet = allowEnvWet;
+        in.inWater = inWater;
+        in.nearWaterfall = nearWaterfall;
+        in.exposed = inPrecipOnActor;
+        in.rain = precipRain;
+        in.snow = precipSnow;
+        in.nearHeat = probeHeat && wd.cachedNearHeat;
+        in.active = actFlags != 0;
+        in.forced = manualMode && policy.hasOverride;
+        in.forcedWet = policy.forcedWet;
+        in.forcedMask = policy.forcedMask;
+
+        // API threads read simTime, envClass, simCat, the sources and wetness together under the lock
+        std::unique_lock simLock(_mtx);
+        float wetByCat[4]{};
+        float wFinal = 0.f;
         {
-            const bool actEnabled = Settings::activityWetEnabled.load();
-            const int actMask = (Settings::activityCatMask.load() & 0x0F);
-
-            bool condRun = false;
-            bool condSneak = false;
-            bool condWork = false;
-
-            if (actEnabled && actMask != 0) {
-                if (Settings::activityTriggerRunning.load()) {
-                    condRun = a->IsRunning() && !inWater;
-                }
-                if (Settings::activityTriggerSneaking.load()) {
-                    condSneak = a->IsSneaking() && !inWater;
-                }
-                if (Settings::activityTriggerWorking.load()) {
-                    condWork = IsActorWorkingFurniture(a) && !inWater;
-                    if (!condWork && a->IsPlayerRef()) {
-                        if (auto* ui = RE::UI::GetSingleton()) {
-                            condWork = ui->IsMenuOpen("Crafting Menu") || ui->IsMenuOpen("Alchemy Menu") ||
-                                       ui->IsMenuOpen("Enchanting Menu") || ui->IsMenuOpen("Cooking Menu");
-                        }
-                    }
-                }
-
-                const bool anyAct = condRun || condSneak || condWork;
-
-                const float upRate = (Settings::secondsToSoakActivity.load() > 0.01f)
-                                         ? (1.f / Settings::secondsToSoakActivity.load())
-                                         : 1.f;
-                const float downRate = (Settings::secondsToDryActivity.load() > 0.01f)
-                                           ? (1.f / Settings::secondsToDryActivity.load())
-                                           : 1.f;
-
-                if (anyAct && !envDominates) {
-                    wd.activityLevel = clampf(wd.activityLevel + upRate * dt, 0.f, 1.f);
-                } else {
-                    wd.activityLevel = clampf(wd.activityLevel - downRate * dt, 0.f, 1.f);
-                }
-
-                if (wd.activityLevel > 0.0005f) {
-                    auto& src = wd.extSources["__activity"];
-                    src.value = wd.activityLevel;
-                    src.expiryRemainingSec = -1.f;
-                    src.catMask = static_cast<std::uint8_t>(actMask);
-                    src.flags = 0;
-                } else {
-                    wd.extSources.erase("__activity");
-                }
-            } else {
-                wd.activityLevel = 0.f;
-                wd.extSources.erase("__activity");
-            }
+            SWE_PROFILE_SCOPE(WetByCategory);
+            wFinal = Sim::UpdateActor(wd, in, cfg, wetByCat);
+            UpdateActiveOverrides(wd, in.EnvDominates());
         }
+        NoteWetness(a, wd.wetness, wFinal);
+        wd.wetness = wFinal;
 
-        auto purgeActivity = [&]() {
-            wd.activityLevel = 0.0f;
-            auto it = wd.extSources.find("__activity");
-            if (it != wd.extSources.end()) {
-                wd.extSources.erase(it);
+        if (Rec::IsRecording()) {
+            std::uint16_t env = 0;
+            if (inWater) env |= Rec::kEnvWater;
+            if (precipRain) env |= Rec::kEnvRain;
+            if (precipSnow) env |= Rec::kEnvSnow;
+            if (isInterior) env |= Rec::kEnvInterior;
+            if (inPrecipOnActor) env |= Rec::kEnvExposed;
+            if (in.nearHeat) env |= Rec::kEnvNearHeat;
+            if (nearWaterfall) env |= Rec::kEnvWaterfall;
+            if (allowEnvWet) env |= Rec::kEnvAllowEnv;
+            if (manualMode) env |= Rec::kEnvManual;
+            Rec::Actor(a->GetFormID(), policy.baseID, env, GetSubmergedLevel(a), actFlags);
+        }
+        simLock.unlock();
+
+        // nothing else to apply: look for new equipment, which has to be bound and applied again
+        bool geomChanged = false;
+        if (wFinal > Sim::kDryWetness && !Sim::ChangedCategories(wd.lastAppliedCat, wetByCat)) {
+            const auto now = _world.now;
+            if (wd.lastGeomProbe.time_since_epoch().count() == 0 || (now - wd.lastGeomProbe) > 250ms) {
+                SWE_PROFILE_SCOPE(StampProbe);
+                RE::NiAVObject* roots[2];
+                ResolveRenderRoots(a, roots);
+                std::uint32_t stamp = 0;
+                if (roots[0]) stamp ^= ComputeGeomStamp(roots[0]);
+                if (roots[1]) stamp ^= ComputeGeomStamp(roots[1]);
+
+                geomChanged = (stamp != wd.lastGeomStamp);
+                wd.lastGeomStamp = stamp;
+                wd.lastGeomProbe = now;
             }
-        };
-
-        if (envDominates) {
-            purgeActivity();
         }
+        if (geomChanged) Rec::GeomChanged(a->GetFormID());
 
-        bool hasOtherExternal = std::any_of(wd.extSources.begin(), wd.extSources.end(), [](const auto& kv) {
-            const auto& key = kv.first;
-            const auto& src = kv.second;
-            if (key == "__activity") return false;
-            if (src.expiryRemainingSec == 0.f) return false;
-            return src.value > 0.f && (src.catMask & SWE::Papyrus::SWE_CAT_MASK_4BIT) != 0;
-        });
-        if (hasOtherExternal) {
-            purgeActivity();
+        if (const std::uint8_t applyMask = Sim::CommitApplied(wd, wetByCat, wFinal, geomChanged)) {
+            // once dry, only categories that still carry applied wetness need their materials restored
+            const float zeros[4]{0, 0, 0, 0};
+            QueueApply(a, (wFinal <= Sim::kDryWetness) ? zeros : wetByCat, applyMask);
         }
+    }
 
-        w = clampf(w, 0.f, 1.f);
-        // wd.baseWetness = w;
+    void WetController::RebuildGeomIndex(GeomIndex& idx, RE::NiAVObject* const roots[2], std::uint32_t stamp) {
+        for (auto& v : idx.byCat) v.clear();
+        idx.eyes.clear();
 
-        float wetByCat[4]{};
-        ComputeWetByCategory(wd, w, wetByCat, dt, envDominates, dryMul);
+        for (int r = 0; r < 2; ++r) {
+            idx.roots[r] = roots[r];
+            if (!roots[r]) continue;
+            ForEachGeometry(roots[r], [&](RE::BSGeometry* g) {
+                auto* lsp = FindLightingProp(g);
+                if (!lsp) return;
+                if (IsEyeGeometry(g, lsp)) {
+                    idx.eyes.push_back({g, lsp});
+                    return;
+                }
+                const int ci = CatIndex(ClassifyGeom(g, lsp));
+                auto* mat = static_cast<RE::BSLightingShaderMaterialBase*>(lsp->material);
+                const bool pbr = MaterialLooksPBR(mat) || (ci >= 2 && IsTruePBR_CS(lsp));
+                idx.byCat[ci].push_back({g, lsp, pbr});
+            });
+        }
 
-        float forcedW = -1.0f;
-        std::uint8_t forcedMask = 0;
-        const bool hasOv = getOverride(forcedW, forcedMask);
+        idx.stamp = stamp;
+        idx.valid = true;
+    }
+
+    WetController::ResponseSettings WetController::LoadResponseSettings(const Settings::Config& cfg) {
+        ResponseSettings s{};
+        s.maxGloss = cfg.maxGlossiness;
+        s.maxSpec = cfg.maxSpecularStrength;
+        s.minGloss = std::min(cfg.minGlossiness, s.maxGloss);
+        s.minSpec = std::min(cfg.minSpecularStrength, s.maxSpec);
+        s.glossBoost = std::min(60.0f, cfg.glossinessBoost);
+        s.specBoost = cfg.specularScaleBoost;
+        s.skinHairMul = std::max(0.1f, cfg.skinHairResponseMul);
+        s.pbrFriendly = cfg.pbrFriendlyMode;
+        s.clearcoat = cfg.pbrClearcoatOnWet;
+        s.clearcoatMul = std::clamp(cfg.pbrClearcoatScale, 0.0f, 1.0f);
+        s.armorWeapMul = std::clamp(cfg.pbrArmorWeapMul, 0.0f, 1.0f);
+        s.pbrMaxGloss = cfg.pbrMaxGlossArmor;
+        s.pbrMaxSpec = cfg.pbrMaxSpecArmor;
+        s.catEnabled = cfg.catEnabledMask;
+        return s;
+    }
 
-        if (hasOv) {
-            for (int ci = 0; ci < 4; ++ci) {
-                if (forcedMask & (1u << ci)) {
-                    wetByCat[ci] = forcedW;
-                }
+    void WetController::CompileResponseProfiles(const ResponseSettings& s, const WetData::CatOverrides ov[4],
+                                                ResponseProfile out[4][2]) {
+        for (int ci = 0; ci < 4; ++ci) {
+            const auto& o = ov[ci];
+            const bool skinOrHair = (ci <= 1);
+            const float catMul =
+                skinOrHair ? ((o.skinHairMul >= 0.f) ? std::max(0.1f, o.skinHairMul) : s.skinHairMul) : 1.0f;
+
+            ResponseProfile base{};
+            base.enabled = (s.catEnabled & (1u << ci)) != 0;
+            base.maxGloss = (o.maxGloss >= 0.f) ? std::min(s.maxGloss, o.maxGloss) : s.maxGloss;
+            base.maxSpec = (o.maxSpec >= 0.f) ? std::min(s.maxSpec, o.maxSpec) : s.maxSpec;
+            base.minGloss = (o.minGloss >= 0.f) ? std::max(s.minGloss, o.minGloss) : s.minGloss;
+            base.minSpec = (o.minSpec >= 0.f) ? std::max(s.minSpec, o.minSpec) : s.minSpec;
+            base.glossGain = ((o.glossBoost >= 0.f) ? std::min(60.0f, o.glossBoost) : s.glossBoost) * catMul;
+            base.scaleGain = ((o.specBoost >= 0.f) ? o.specBoost : s.specBoost) * catMul;
+
+            // [0] = classic material, [1] = material that looks PBR
+            out[ci][0] = base;
+            out[ci][0].kernel = &WetKernel<false, false>;
+
+            out[ci][1] = base;
+            if (!s.pbrFriendly) {
+                out[ci][1].kernel = &WetKernel<false, false>;
+            } else if (skinOrHair) {
+                out[ci][1].kernel = &WetKernel<true, false>;
+            } else {
+                // clearcoat and the armor/weapon response both pull the result back towards the base linearly
+                out[ci][1].blend = s.armorWeapMul * (s.clearcoat ? s.clearcoatMul : 1.0f);
+                out[ci][1].capGloss = s.pbrMaxGloss;
+                out[ci][1].capSpec = s.pbrMaxSpec;
+                out[ci][1].forceSpecular = s.clearcoat;
+                out[ci][1].kernel = &WetKernel<true, true>;
             }
         }
+    }
 
-        if (!Settings::affectSkin.load()) wetByCat[0] = 0.0f;
-        if (!Settings::affectHair.load()) wetByCat[1] = 0.0f;
-        if (!Settings::affectArmor.load()) wetByCat[2] = 0.0f;
-        if (!Settings::affectWeapons.load()) wetByCat[3] = 0.0f;
-
-        float wFinal = std::max(std::max(wetByCat[0], wetByCat[1]), std::max(wetByCat[2], wetByCat[3]));
-        wd.wetness = wFinal;
+    void WetController::RestoreMaterial(RE::BSGeometry* g, RE::BSLightingShaderProperty* lsp,
+                                        RE::BSLightingShaderMaterialBase* mat, const MatSnapshot& base) {
+        auto* sp = static_cast<RE::BSShaderProperty*>(lsp);
+        SetSpecularEnabled(sp, base.hadSpecular);
+        mat->materialAlpha = base.baseAlpha;
+        mat->specularPower = base.baseSpecularPower;
+        mat->specularColorScale = base.baseSpecularScale;
+        mat->specularColor = {base.baseSpecR, base.baseSpecG, base.baseSpecB};
 
-        const float prevMax = std::max(std::max(wd.lastAppliedCat[0], wd.lastAppliedCat[1]),
-                                       std::max(wd.lastAppliedCat[2], wd.lastAppliedCat[3]));
-        if (wFinal <= 0.0005f) {
-            if (prevMax > 0.0005f) {
-                const float zeros[4]{0, 0, 0, 0};
-                ApplyWetnessMaterials(a, zeros);
-                wd.lastAppliedCat[0] = wd.lastAppliedCat[1] = wd.lastAppliedCat[2] = wd.lastAppliedCat[3] = 0.f;
-                wd.lastAppliedWet = 0.0f;
-
-                wd.simCat[0] = wd.simCat[1] = wd.simCat[2] = wd.simCat[3] = 0.f;
-                wd.simInit = true;
-            }
-        } else {
-            bool anyChange = false;
-            for (int i = 0; i < 4; ++i) {
-                if (std::abs(wd.lastAppliedCat[i] - wetByCat[i]) > 0.0025f) {
-                    anyChange = true;
-                    break;
-                }
-            }
+        sp->SetMaterial(mat, true);
+        lsp->DoClearRenderPasses();
+        (void)lsp->SetupGeometry(g);
+        PerfAdd(kPerfSetupGeometry);
+        (void)lsp->FinishSetupGeometry(g);
+    }
 
-            bool geomChanged = false;
-            if (!anyChange) {
-                const auto now = std::chrono::steady_clock::now();
-                if (wd.lastGeomProbe.time_since_epoch().count() == 0 || (now - wd.lastGeomProbe) > 250ms) {
-                    RE::NiAVObject* third = a->Get3D();
-                    RE::NiAVObject* first = nullptr;
-                    if (a->IsPlayerRef() && third) {
-                        first = third->GetObjectByName("1st Person");
-                        if (!first) first = third->GetObjectByName("1stPerson");
-                    }
-                    std::uint32_t stamp = 0;
-                    if (third) stamp ^= ComputeGeomStamp(third);
-                    if (first) stamp ^= ComputeGeomStamp(first);
+    template <bool kPbr, bool kArmorBlend>
+    void WetController::WetKernel(RE::BSGeometry* g, RE::BSLightingShaderProperty* lsp,
+                                  RE::BSLightingShaderMaterialBase* mat, const MatSnapshot& base,
+                                  const ResponseProfile& p, float wet) {
+        auto* sp = static_cast<RE::BSShaderProperty*>(lsp);
 
-                    geomChanged = (stamp != wd.lastGeomStamp);
-                    wd.lastGeomStamp = stamp;
-                    wd.lastGeomProbe = now;
-                }
-            }
+        if constexpr (kPbr) {
+            SetSpecularEnabled(sp, p.forceSpecular || base.hadSpecular);
+        } else {
+            SetSpecularEnabled(sp, true);
+        }
 
-            if (anyChange || geomChanged) {
-                ApplyWetnessMaterials(a, wetByCat);
-                for (int i = 0; i < 4; ++i) wd.lastAppliedCat[i] = wetByCat[i];
-                wd.lastAppliedWet = wFinal;
+        RE::NiColor newSpec{base.baseSpecR, base.baseSpecG, base.baseSpecB};
+        if constexpr (!kPbr) {
+            if ((newSpec.red + newSpec.green + newSpec.blue) < 0.05f) {
+                newSpec = {0.7f, 0.7f, 0.7f};
             }
         }
-    }
 
-    void SWE::WetController::ApplyWetnessMaterials(RE::Actor* a, const float wetByCat[4]) {
-        if (!a) return;
+        float newGloss = std::clamp(base.baseSpecularPower + wet * p.glossGain, p.minGloss, p.maxGloss);
+        float newScale = std::clamp(base.baseSpecularScale + wet * p.scaleGain, p.minSpec, p.maxSpec);
 
-        RE::NiAVObject* third = a->Get3D();
-        RE::NiAVObject* first = nullptr;
-        if (a->IsPlayerRef() && third) {
-            first = third->GetObjectByName("1st Person");
-            if (!first) first = third->GetObjectByName("1stPerson");
+        if constexpr (kArmorBlend) {
+            newGloss = std::min(base.baseSpecularPower + (newGloss - base.baseSpecularPower) * p.blend, p.capGloss);
+            newScale = std::min(base.baseSpecularScale + (newScale - base.baseSpecularScale) * p.blend, p.capSpec);
         }
-        RE::NiAVObject* roots[2] = {third, first};
 
-        const float maxWet = std::max(std::max(wetByCat[0], wetByCat[1]), std::max(wetByCat[2], wetByCat[3]));
-        /*
-        if (maxWet > 0.0005f) {
-            const bool anyToggle = Settings::affectSkin.load() || Settings::affectHair.load() ||
-                                   Settings::affectArmor.load() || Settings::affectWeapons.load();
-            if (!anyToggle) return;
+        mat->specularPower = newGloss;
+        mat->specularColor = newSpec;
+        mat->specularColorScale = newScale;
+        mat->materialAlpha = base.baseAlpha;
+
+        sp->SetMaterial(mat, true);
+        lsp->DoClearRenderPasses();
+        (void)lsp->SetupGeometry(g);
+        PerfAdd(kPerfSetupGeometry);
+        (void)lsp->FinishSetupGeometry(g);
+    }
+
+    std::uint8_t SWE::WetController::ApplyWetnessMaterials(RE::Actor* a, const float wetByCat[4],
+                                                           std::uint8_t catMask) {
+        if (!a) return 0;
+
+        RE::NiAVObject* roots[2];
+        ResolveRenderRoots(a, roots);
+        RE::NiAVObject* third = roots[0];
+        RE::NiAVObject* first = roots[1];
+
+        auto& wd = WetOf(a->GetFormID());
+
+        // Profiles only need recompiling when the global response settings or this actor's overrides changed
+        const ResponseSettings rs = LoadResponseSettings(*_cfg);
+        auto& key = wd.profileKey;
+        if (!key.valid || !(key.settings == rs) || !std::equal(std::begin(key.ov), std::end(key.ov), wd.activeOv)) {
+            CompileResponseProfiles(rs, wd.activeOv, wd.profiles);
+            key.settings = rs;
+            std::copy(std::begin(wd.activeOv), std::end(wd.activeOv), key.ov);
+            key.valid = true;
         }
-        */
 
-        const float defMaxGloss = Settings::maxGlossiness.load();
-        const float defMaxSpec = Settings::maxSpecularStrength.load();
-        const float defMinGloss = std::min(Settings::minGlossiness.load(), defMaxGloss);
-        const float defMinSpec = std::min(Settings::minSpecularStrength.load(), defMaxSpec);
-        const float defGlBoost = std::min(60.0f, Settings::glossinessBoost.load());
-        const float defScBoost = Settings::specularScaleBoost.load();
-        const float defSkinHair = std::max(0.1f, Settings::skinHairResponseMul.load());
+        // The stamp walk is cheap (no string work), and it guarantees the bound pointers are still alive
+        std::uint32_t stamp = 0;
+        if (third) stamp ^= ComputeGeomStamp(third);
+        if (first) stamp ^= ComputeGeomStamp(first);
 
-        auto& wd = _wet[a->GetFormID()];
+        auto& idx = wd.geomIndex;
+        const bool rebuild = !idx.valid || idx.stamp != stamp || idx.roots[0] != third || idx.roots[1] != first;
+        if (rebuild) {
+            RebuildGeomIndex(idx, roots, stamp);
+            catMask = 0x0F;
+        }
 
         int geomsTouched = 0, propsTouched = 0;
 
-        auto touchGeom = [&](RE::BSGeometry* g) {
-            auto* lsp = FindLightingProp(g);
-            if (!lsp) return;
-
-            if (IsEyeGeometry(g, lsp)) {
-                auto it = _matCache.find(lsp);
-                if (it != _matCache.end()) {
-                    auto* mat = static_cast<RE::BSLightingShaderMaterialBase*>(lsp->material);
-                    auto* sp = static_cast<RE::BSShaderProperty*>(lsp);
-                    const MatSnapshot& base = it->second;
-                    if (mat && sp) {
-                        SetSpecularEnabled(sp, base.hadSpecular);
-                        mat->materialAlpha = base.baseAlpha;
-                        mat->specularPower = base.baseSpecularPower;
-                        mat->specularColorScale = base.baseSpecularScale;
-                        mat->specularColor = {base.baseSpecR, base.baseSpecG, base.baseSpecB};
-                        sp->SetMaterial(mat, true);
-                        lsp->DoClearRenderPasses();
-                        (void)lsp->SetupGeometry(g);
-                        (void)lsp->FinishSetupGeometry(g);
-                    }
-                }
-                return;
-            }
-
-            const MatCat cat = ClassifyGeom(g, lsp);
-            const bool toggledOff = (cat == MatCat::SkinFace && !Settings::affectSkin.load()) ||
-                                    (cat == MatCat::Hair && !Settings::affectHair.load()) ||
-                                    (cat == MatCat::ArmorClothing && !Settings::affectArmor.load()) ||
-                                    (cat == MatCat::Weapon && !Settings::affectWeapons.load());
-
-            const int ci = CatIndex(cat);
-            float wet = std::clamp(wetByCat[ci], 0.0f, 1.0f);
-
-            if (toggledOff) {
-                wet = 0.0f;
-            }
-
-            const auto& ov = wd.activeOv[ci];
-            const float effMaxGloss = (ov.maxGloss >= 0.f) ? std::min(defMaxGloss, ov.maxGloss) : defMaxGloss;
-            const float effMaxSpec = (ov.maxSpec >= 0.f) ? std::min(defMaxSpec, ov.maxSpec) : defMaxSpec;
-            const float effMinGloss = (ov.minGloss >= 0.f) ? std::max(defMinGloss, ov.minGloss) : defMinGloss;
-            const float effMinSpec = (ov.minSpec >= 0.f) ? std::max(defMinSpec, ov.minSpec) : defMinSpec;
-            const float effGlBoost = (ov.glossBoost >= 0.f) ? std::min(60.0f, ov.glossBoost) : defGlBoost;
-            const float effScBoost = (ov.specBoost >= 0.f) ? ov.specBoost : defScBoost;
-            const float catMul = (cat == MatCat::SkinFace || cat == MatCat::Hair)
-                                     ? ((ov.skinHairMul >= 0.f) ? std::max(0.1f, ov.skinHairMul) : defSkinHair)
-                                     : 1.0f;
-
-            auto* mat = static_cast<RE::BSLightingShaderMaterialBase*>(lsp->material);
-            if (!mat) return;
-
+        auto snapshotOf = [&](RE::BSLightingShaderProperty* lsp,
+                              RE::BSLightingShaderMaterialBase* mat) -> const MatSnapshot& {
             auto it = _matCache.find(lsp);
+            PerfAdd(it == _matCache.end() ? kPerfMatCacheMisses : kPerfMatCacheHits);
             if (it == _matCache.end()) {
-                bool hadSpec = false;
-                if (auto* sp0 = static_cast<RE::BSShaderProperty*>(lsp)) {
-                    hadSpec = sp0->flags.any(RE::BSShaderProperty::EShaderPropertyFlag::kSpecular);
-                }
-                _matCache.emplace(lsp, MatSnapshot{.baseAlpha = mat->materialAlpha,
+                const bool hadSpec = lsp->flags.any(RE::BSShaderProperty::EShaderPropertyFlag::kSpecular);
+                it = _matCache
+                         .emplace(lsp, MatSnapshot{.baseAlpha = mat->materialAlpha,
                                                    .baseSpecularPower = mat->specularPower,
                                                    .baseSpecularScale = mat->specularColorScale,
                                                    .baseSpecR = mat->specularColor.red,
                                                    .baseSpecG = mat->specularColor.green,
                                                    .baseSpecB = mat->specularColor.blue,
-                                                   .hadSpecular = hadSpec});
-                it = _matCache.find(lsp);
+                                                   .hadSpecular = hadSpec})
+                         .first;
             }
-            const MatSnapshot& base = it->second;
-
-            auto* sp = static_cast<RE::BSShaderProperty*>(lsp);
+            return it->second;
+        };
 
-            const bool isArmorOrWeap = (cat == MatCat::ArmorClothing || cat == MatCat::Weapon);
+        if (rebuild) {
+            for (const auto& b : idx.eyes) {
+                auto it = _matCache.find(b.lsp);
+                auto* mat = static_cast<RE::BSLightingShaderMaterialBase*>(b.lsp->material);
+                if (it != _matCache.end() && mat) RestoreMaterial(b.geom, b.lsp, mat, it->second);
+            }
+        }
 
-            const bool likelyPBR = MaterialLooksPBR(mat);
-            const bool csTruePBR = isArmorOrWeap && lsp && IsTruePBR_CS(lsp);
+        for (int ci = 0; ci < 4; ++ci) {
+            if ((catMask & (1u << ci)) == 0) continue;
+            const float catWet = std::clamp(wetByCat[ci], 0.0f, 1.0f);
 
-            //const bool pbrMode = Settings::pbrFriendlyMode.load() && (isArmorOrWeap || likelyPBR);
-            const bool pbrish = Settings::pbrFriendlyMode.load() && (likelyPBR || csTruePBR);
+            for (const auto& b : idx.byCat[ci]) {
+                ++geomsTouched;
+                auto* mat = static_cast<RE::BSLightingShaderMaterialBase*>(b.lsp->material);
+                if (!mat) continue;
 
-            if (wet <= 0.0005f) {
-                if (sp) {
-                    SetSpecularEnabled(sp, base.hadSpecular);
-                }
-                mat->materialAlpha = base.baseAlpha;
-                mat->specularPower = base.baseSpecularPower;
-                mat->specularColorScale = base.baseSpecularScale;
-                mat->specularColor = {base.baseSpecR, base.baseSpecG, base.baseSpecB};
-
-                sp->SetMaterial(mat, true);
-                lsp->DoClearRenderPasses();
-                (void)lsp->SetupGeometry(g);
-                (void)lsp->FinishSetupGeometry(g);
-                ++propsTouched;
-                return;
-            }
+                const MatSnapshot& base = snapshotOf(b.lsp, mat);
+                const ResponseProfile& p = wd.profiles[ci][b.pbr ? 1 : 0];
+                const float wet = p.enabled ? catWet : 0.0f;
 
-            if (sp) {
-                if (pbrish) {
-                    SetSpecularEnabled(sp, base.hadSpecular);
+                if (wet <= 0.0005f) {
+                    RestoreMaterial(b.geom, b.lsp, mat, base);
                 } else {
-                    SetSpecularEnabled(sp, true);
+                    p.kernel(b.geom, b.lsp, mat, base, p, wet);
                 }
+                ++propsTouched;
             }
-
-
-            RE::NiColor newSpec{base.baseSpecR, base.baseSpecG, base.baseSpecB};
-            if ((newSpec.red + newSpec.green + newSpec.blue) < 0.05f) {
-                if (!pbrish) {
-                    newSpec = {0.7f, 0.7f, 0.7f};
-                }
-            }
-            float newGloss = base.baseSpecularPower + wet * effGlBoost * catMul;
-            newGloss = std::clamp(newGloss, effMinGloss, effMaxGloss);
-
-            float newScale = base.baseSpecularScale + wet * effScBoost * catMul;
-            newScale = std::clamp(newScale, effMinSpec, effMaxSpec);
-
-            // PBR Clearcoat simulation on wetness for armor and weapons
-            if (wet > 0.0005f && pbrish && isArmorOrWeap && Settings::pbrClearcoatOnWet.load()) {
-                if (sp) SetSpecularEnabled(sp, true);
-                if ((mat->specularColor.red + mat->specularColor.green + mat->specularColor.blue) < 0.05f) {
-                    mat->specularColor = {Settings::pbrClearcoatSpec.load(), Settings::pbrClearcoatSpec.load(),
-                                          Settings::pbrClearcoatSpec.load()};
-                }
-                const float ccMul = std::clamp(Settings::pbrClearcoatScale.load(), 0.0f, 1.0f);
-                newScale = base.baseSpecularScale + (newScale - base.baseSpecularScale) * ccMul;
-                newGloss = base.baseSpecularPower + (newGloss - base.baseSpecularPower) * ccMul;
-            }
-
-            if (pbrish && isArmorOrWeap) {
-                const float amul = std::clamp(Settings::pbrArmorWeapMul.load(), 0.0f, 1.0f);
-                const float pbrG = Settings::pbrMaxGlossArmor.load();
-                const float pbrS = Settings::pbrMaxSpecArmor.load();
-
-                newGloss = base.baseSpecularPower + (newGloss - base.baseSpecularPower) * amul;
-                newScale = base.baseSpecularScale + (newScale - base.baseSpecularScale) * amul;
-                newGloss = std::min(newGloss, pbrG);
-                newScale = std::min(newScale, pbrS);
-            }
-
-            mat->specularPower = newGloss;
-            mat->specularColor = newSpec;
-            mat->specularColorScale = newScale;
-            mat->materialAlpha = base.baseAlpha;
-
-            sp->SetMaterial(mat, true);
-            lsp->DoClearRenderPasses();
-            (void)lsp->SetupGeometry(g);
-            (void)lsp->FinishSetupGeometry(g);
-
-            ++propsTouched;
-        };
-
-        for (RE::NiAVObject* root : roots) {
-            if (!root) continue;
-            ForEachGeometry(root, [&](RE::BSGeometry* g) {
-                ++geomsTouched;
-                touchGeom(g);
-            });
         }
 
         static auto lastToast = std::chrono::steady_clock::now();
         if (a->IsPlayerRef() && std::chrono::steady_clock::now() - lastToast > 1s) {
             lastToast = std::chrono::steady_clock::now();
         }
+        SWE_PROFILE_COUNT(Geometries, static_cast<std::uint32_t>(geomsTouched));
+        PerfAdd(kPerfMaterialsTouched, static_cast<std::uint64_t>(propsTouched));
+        return catMask;
     }
 
     bool WetController::IsNearHeatSource(const RE::Actor* a, float radius) const {
@@ -1517,6 +1611,8 @@ namespace SWE {
         bool found = false;
         cell->ForEachReference([&](RE::TESObjectREFR& ref) {
             if (found) return RE::BSContainer::ForEachResult::kStop;
+            SWE_PROFILE_COUNT(Refs, 1);
+            PerfAdd(kPerfRefsScanned);
 
             if (&ref == a || !ref.Is3DLoaded()) return RE::BSContainer::ForEachResult::kContinue;
 
@@ -1532,59 +1628,49 @@ namespace SWE {
         return found;
     }
 
-    void WetController::ComputeWetByCategory(WetData& wd, float baseWet, float outWetByCat[4], float dt,
-                                             bool envDominates, float dryMul) {
-        std::scoped_lock l(_mtx);
+    static_assert(Sim::kFlagPassthrough == SWE::Papyrus::SWE_FLAG_PASSTHROUGH &&
+                  Sim::kFlagNoAutoDry == SWE::Papyrus::SWE_FLAG_NO_AUTODRY &&
+                  Sim::kFlagZeroBase == SWE::Papyrus::SWE_FLAG_ZERO_BASE &&
+                  Sim::kCatMask == SWE::Papyrus::SWE_CAT_MASK_4BIT);
 
-        for (auto it = wd.extSources.begin(); it != wd.extSources.end();) {
-            if (it->second.expiryRemainingSec >= 0.f) {
-                it->second.expiryRemainingSec -= std::max(0.f, dt);
-                if (it->second.expiryRemainingSec <= 0.f) {
-                    it = wd.extSources.erase(it);
-                    continue;
-                }
-            }
-            ++it;
-        }
-
-        if (!wd.simInit) {
-            for (int i = 0; i < 4; ++i) wd.simCat[i] = wd.lastAppliedCat[i];
-            wd.simInit = true;
-        }
+    void WetController::Settle(WetData& wd, double until) {
+        if (wd.simTime < 0.0 || until - wd.simTime < 1e-3) return;
+        std::scoped_lock l(_mtx);
+        Sim::SettleActor(wd, until, _stepDt.load(std::memory_order_relaxed), *_cfg);
+    }
 
-        // Important: Environmental wetness sources override everything else
+    void WetController::RecordState(std::uint32_t formID, WetData& wd, double clock) {
+        std::scoped_lock l(_mtx);
+        wd.recSession = Rec::Session();
+        Rec::StateRec st;
+        st.wetness = wd.wetness;
+        st.lastAppliedWet = wd.lastAppliedWet;
+        std::copy(std::begin(wd.lastAppliedCat), std::end(wd.lastAppliedCat), st.lastAppliedCat);
+        std::copy(std::begin(wd.simCat), std::end(wd.simCat), st.simCat);
+        st.simInit = wd.simInit;
+        st.activityLevel = wd.activityLevel;
+        st.simAge = (wd.simTime < 0.0) ? -1.0 : clock - wd.simTime;
+        st.envClass = static_cast<std::uint8_t>(wd.envClass);
+        st.sources.reserve(wd.extSources.size());
+        for (const auto& [key, src] : wd.extSources)
+            st.sources.push_back({key, src.value, src.expiryRemainingSec, src.catMask, src.flags});
+        Rec::State(formID, st);
+    }
+
+    float WetController::SettledState(const WetData& wd, const Settings::Config& cfg, double until,
+                                      float outCat[4]) const {
+        for (int ci = 0; ci < 4; ++ci) outCat[ci] = wd.simInit ? wd.simCat[ci] : std::max(0.f, wd.lastAppliedCat[ci]);
+        if (wd.simTime < 0.0 || until - wd.simTime < 1e-3) return wd.wetness;
+        return Sim::Settle(outCat, wd.lastAppliedCat, wd.extSources, static_cast<float>(until - wd.simTime),
+                           wd.envClass, _stepDt.load(std::memory_order_relaxed), cfg);
+    }
+
+    void WetController::UpdateActiveOverrides(WetData& wd, bool envDominates) {
         if (envDominates) {
-            for (int i = 0; i < 4; ++i) {
-                wd.activeOv[i] = {};
-                outWetByCat[i] = baseWet;
-                wd.simCat[i] = baseWet;
-            }
-            wd.simInit = true;
+            for (auto& ov : wd.activeOv) ov = {};
             return;
         }
 
-        float last[4] = {wd.lastAppliedCat[0], wd.lastAppliedCat[1], wd.lastAppliedCat[2], wd.lastAppliedCat[3]};
-        float baseByCat[4] = {wd.simCat[0], wd.simCat[1], wd.simCat[2], wd.simCat[3]};
-
-        auto dryStep = [&](float secs) -> float {
-            const float r = (secs > 0.01f) ? (1.f / secs) : 1.f;
-            return r * dryMul * dt;
-        };
-
-        const float secSkin = Settings::secondsToDrySkin.load();
-        const float secHair = Settings::secondsToDryHair.load();
-        const float secArmor = Settings::secondsToDryArmor.load();
-        const float secWeap = Settings::secondsToDryWeapon.load();
-
-        baseByCat[0] = clampf(baseByCat[0] - dryStep(secSkin), 0.f, 1.f);
-        baseByCat[1] = clampf(baseByCat[1] - dryStep(secHair), 0.f, 1.f);
-        baseByCat[2] = clampf(baseByCat[2] - dryStep(secArmor), 0.f, 1.f);
-        baseByCat[3] = clampf(baseByCat[3] - dryStep(secWeap), 0.f, 1.f);
-
-        float passthrough[4] = {0.f, 0.f, 0.f, 0.f};
-        bool zeroBase[4] = {false, false, false, false};
-        bool noAutoDry[4] = {false, false, false, false};
-
         auto mergeOv = [&](WetData::CatOverrides& ov, const OverrideParams& sOv) {
             ov.any = true;
             if (sOv.maxGloss >= 0.f)
@@ -1600,59 +1686,8 @@ namespace SWE {
 
         for (auto& [k, s] : wd.extSources) {
             if (s.expiryRemainingSec == 0.f) continue;
-            const bool isPT = (s.flags & SWE::Papyrus::SWE_FLAG_PASSTHROUGH) != 0;
-            const bool zBase = (s.flags & SWE::Papyrus::SWE_FLAG_ZERO_BASE) != 0;
-            const bool nad = (s.flags & SWE::Papyrus::SWE_FLAG_NO_AUTODRY) != 0;
-
             for (int ci = 0; ci < 4; ++ci)
-                if (s.catMask & (1u << ci)) {
-                    mergeOv(wd.activeOv[ci], s.ov);
-                    if (isPT) passthrough[ci] += s.value;
-                    if (zBase) zeroBase[ci] = true;
-                    if (nad) noAutoDry[ci] = true;
-                }
-        }
-
-        // ZERO_BASE / NO_AUTODRY
-        const bool isDrying = !envDominates;
-        for (int ci = 0; ci < 4; ++ci) {
-            if (zeroBase[ci]) {
-                baseByCat[ci] = 0.f;
-            } else if (noAutoDry[ci] && isDrying) {
-                baseByCat[ci] = last[ci];
-            }
-        }
-
-        auto blendOne = [&](int ci) -> float {
-            float sum = 0.f, mx = 0.f;
-            bool any = false;
-            for (auto& [k, s] : wd.extSources) {
-                if (s.expiryRemainingSec == 0.f) continue;
-                if ((s.flags & SWE::Papyrus::SWE_FLAG_PASSTHROUGH) != 0) continue;
-                if ((s.catMask & (1u << ci)) == 0) continue;
-                any = true;
-                sum += s.value;
-                mx = std::max(mx, s.value);
-            }
-            if (!any) return baseByCat[ci];
-
-            switch (Settings::externalBlendMode.load()) {
-                default:
-                case 0:
-                    return std::max(baseByCat[ci], mx);
-                case 1:
-                    return clampf(baseByCat[ci] + sum, 0.f, 1.f);
-                case 2: {
-                    float rest = std::max(0.f, sum - mx);
-                    float w = clampf(Settings::externalAddWeight.load(), 0.f, 1.f);
-                    return clampf(std::max(baseByCat[ci], mx) + rest * w, 0.f, 1.f);
-                }
-            }
-        };
-
-        for (int ci = 0; ci < 4; ++ci) {
-            outWetByCat[ci] = clampf(blendOne(ci) + passthrough[ci], 0.f, 1.f);
-            wd.simCat[ci] = outWetByCat[ci];
+                if (s.catMask & (1u << ci)) mergeOv(wd.activeOv[ci], s.ov);
         }
     }
 
@@ -1715,8 +1750,10 @@ namespace SWE {
         if (!a) return false;
         const bool anyPrecip = (Settings::rainEnabled.load() && IsRainingCurrent()) ||
                                (Settings::snowEnabled.load() && IsSnowingCurrent());
-        if (!anyPrecip) return false;
+        return anyPrecip && RoofCovers(a);
+    }
 
+    bool WetController::RoofCovers(RE::Actor* a) const {
         const RE::NiPoint3 base = a->GetPosition();
         const float headZ = ActorHeadZ(a) + 5.0f;
         constexpr float toAbove = 4000.0f;
@@ -1761,7 +1798,9 @@ namespace SWE {
     }
 
     float WetController::GetSubmergedLevel(RE::Actor* a) const { return ComputeSubmergeLevel(a); }
-    bool WetController::IsActorWetByWater(RE::Actor* a) const { return SWE::IsActorWetByWater(a); }
+    bool WetController::IsActorWetByWater(RE::Actor* a) const {
+        return SWE::IsActorWetByWater(a, Settings::GetConfig()->minSubmerge);
+    }
     bool WetController::IsWetWeatherAround(RE::Actor* a) const {
         if (!a) return false;
         auto* cell = a->GetParentCell();
@@ -1772,19 +1811,286 @@ namespace SWE {
         return rainNow || snowNow;
     }
 
+    std::uint8_t WetController::ComputeEnvMask(RE::Actor* a) const {
+        std::uint8_t m = 0;
+        if (IsActorWetByWater(a)) m |= SWE::Papyrus::SWE_ENV_WATER;
+        if (IsWetWeatherAround(a)) m |= SWE::Papyrus::SWE_ENV_WET_WEATHER;
+        if (IsNearHeatSource(a, std::max(50.0f, Settings::nearFireRadius.load()))) m |= SWE::Papyrus::SWE_ENV_NEAR_HEAT;
+
+        const bool underRoof = IsUnderRoof(a);
+        if (underRoof) m |= SWE::Papyrus::SWE_ENV_UNDER_ROOF;
+        if (!underRoof && IsActorInExteriorWet(a)) m |= SWE::Papyrus::SWE_ENV_EXTERIOR_OPEN;
+        return m;
+    }
+
+    std::uint32_t WetController::GetEnvMask(RE::Actor* a, float maxAgeSec, float* ageSec) {
+        if (ageSec) *ageSec = 0.f;
+        if (!a) return 0;
+        const auto now = std::chrono::steady_clock::now();
+        // Only live actors can have a cached mask; saved and cold ones are not pulled into _wet by a query
+        const std::uint32_t id = a->GetFormID();
+        if (maxAgeSec > 0.f) {
+            std::uint8_t cached = 0;
+            bool hit = false, heatLazy = false;
+            std::chrono::steady_clock::time_point at{};
+            {
+                std::scoped_lock l(_mtx);
+                const auto it = _wet.find(id);
+                const WetData* wd = (it != _wet.end()) ? &it->second : nullptr;
+                if (wd && wd->envMaskAt.time_since_epoch().count() != 0) {
+                    const float age = std::chrono::duration<float>(now - wd->envMaskAt).count();
+                    if (age <= maxAgeSec) {
+                        if (ageSec) *ageSec = age;
+                        cached = wd->envMask;
+                        heatLazy = wd->envHeatLazy;
+                        at = wd->envMaskAt;
+                        hit = true;
+                    }
+                }
+            }
+            if (hit && !heatLazy) return cached;
+            if (hit) {
+                // the tick does not probe heat in water, only that bit is missing from its mask
+                if (IsNearHeatSource(a, Settings::GetConfig()->heatRadius)) cached |= SWE::Papyrus::SWE_ENV_NEAR_HEAT;
+                std::scoped_lock l(_mtx);
+                if (auto it = _wet.find(id); it != _wet.end() && it->second.envMaskAt == at) {
+                    it->second.envMask = cached;
+                    it->second.envHeatLazy = false;
+                }
+                return cached;
+            }
+        }
+
+        // probe without holding the lock, the rays and the cell scan are the expensive part
+        const std::uint8_t m = ComputeEnvMask(a);
+        std::scoped_lock l(_mtx);
+        if (auto it = _wet.find(id); it != _wet.end()) {
+            it->second.envMask = m;
+            it->second.envMaskAt = now;
+            it->second.envHeatLazy = false;
+        }
+        return m;
+    }
+
+    bool WetController::PeekState(std::uint32_t id, float& outWet, float outCat[4]) const {
+        const auto cfg = Settings::GetConfig();
+        const double clock = _simClock.load(std::memory_order_acquire);
+        if (auto it = _wet.find(id); it != _wet.end()) {
+            outWet = SettledState(it->second, *cfg, clock, outCat);
+            return true;
+        }
+
+        // what Materialize and Thaw would build, without building it
+        if (const CoSave::Actor* saved = FindPending(id)) {
+            outWet = clampf(saved->wetness, 0.f, 1.f);
+            std::fill_n(outCat, 4, 0.f);
+            return true;
+        }
+        if (const ColdActor* c = FindCold(id)) {
+            for (int ci = 0; ci < 4; ++ci) outCat[ci] = c->cat[ci] / 255.f;
+            outWet = std::max(std::max(outCat[0], outCat[1]), std::max(outCat[2], outCat[3]));
+            if (clock - c->simSec >= 1e-3) {
+                static const decltype(WetData::extSources) kNoSources;
+                static constexpr float kNeverApplied[4]{-1.f, -1.f, -1.f, -1.f};
+                outWet = Sim::Settle(outCat, kNeverApplied, kNoSources, static_cast<float>(clock - c->simSec),
+                                     static_cast<EnvClass>(c->env), _stepDt.load(std::memory_order_relaxed), *cfg);
+            }
+            return true;
+        }
+        std::fill_n(outCat, 4, 0.f);
+        outWet = 0.f;
+        return false;
+    }
+
+    void WetController::PutState(std::size_t i, float wet, const float cat[4], float* outWet, float* outCat) {
+        if (outWet) outWet[i] = wet;
+        if (outCat) std::copy_n(cat, 4, outCat + 4 * i);
+    }
+
+    std::size_t WetController::QueryActors(std::span<RE::Actor* const> actors, float* outWet, float* outCat,
+                                           std::uint32_t* outEnv) {
+        std::size_t tracked = 0;
+        std::vector<std::size_t> stale, heatLazy;
+        const auto now = std::chrono::steady_clock::now();
+        const auto maxAge = std::chrono::duration<float>(kEnvMaskMaxAgeSec);
+        {
+            std::scoped_lock l(_mtx);
+            for (std::size_t i = 0; i < actors.size(); ++i) {
+                const std::uint32_t id = actors[i] ? actors[i]->GetFormID() : 0;
+                float wet = 0.f, cat[4]{};
+                if (id && PeekState(id, wet, cat)) ++tracked;
+                PutState(i, wet, cat, outWet, outCat);
+                if (!outEnv) continue;
+
+                const auto it = id ? _wet.find(id) : _wet.end();
+                const WetData* wd = (it != _wet.end()) ? &it->second : nullptr;
+                const bool fresh = wd && wd->envMaskAt.time_since_epoch().count() != 0 && now - wd->envMaskAt <= maxAge;
+                outEnv[i] = fresh ? wd->envMask : 0u;
+                if (!fresh && actors[i]) stale.push_back(i);
+                if (fresh && wd->envHeatLazy) heatLazy.push_back(i);
+            }
+        }
+
+        // same rule as GetEnvMask, only actors the tick has not probed lately cost a probe, and in-water ones a
+        // heat probe
+        for (const std::size_t i : stale) outEnv[i] = GetEnvMask(actors[i], 0.f);
+        for (const std::size_t i : heatLazy) outEnv[i] = GetEnvMask(actors[i]);
+        return tracked;
+    }
+
+    std::size_t WetController::QueryTrackedActors(std::span<std::uint32_t> outIDs, float* outWet, float* outCat,
+                                                  std::uint32_t* outEnv) {
+        const auto cfg = Settings::GetConfig();
+        std::scoped_lock l(_mtx);
+        const double clock = _simClock.load(std::memory_order_acquire);
+        std::size_t i = 0;
+        for (const auto& [id, wd] : _wet) {
+            if (i == outIDs.size()) break;
+            outIDs[i] = id;
+            float cat[4];
+            const float wet = SettledState(wd, *cfg, clock, cat);
+            PutState(i, wet, cat, outWet, outCat);
+            if (outEnv) outEnv[i] = wd.envMask;
+            ++i;
+        }
+        return _wet.size();
+    }
+
+    std::uint32_t WetController::Subscribe(std::uint32_t formID, float threshold, float hysteresis,
+                                           WetnessCallback cb, void* user) {
+        if (!(threshold > 0.f && threshold <= 1.f)) return 0;
+        auto s = std::make_shared<Subscription>();
+        s->formID = formID;
+        s->threshold = threshold;
+        s->hysteresis = std::clamp(hysteresis, 0.f, threshold);
+        s->cb = cb;
+        s->user = user;
+
+        std::scoped_lock l(_subMtx);
+        s->id = _nextSubID++;
+        auto next = std::make_shared<SubscriptionList>(*_subs.load(std::memory_order_acquire));
+        next->push_back(s);
+        _subs.store(std::move(next), std::memory_order_release);
+        return s->id;
+    }
+
+    bool WetController::Unsubscribe(std::uint32_t id) {
+        std::scoped_lock l(_subMtx);
+        auto next = std::make_shared<SubscriptionList>(*_subs.load(std::memory_order_acquire));
+        const auto it = std::ranges::find_if(*next, [&](const auto& s) { return s->id == id; });
+        if (it == next->end()) return false;
+        (*it)->active = false;  // events already queued for it are dropped
+        next->erase(it);
+        _subs.store(std::move(next), std::memory_order_release);
+        return true;
+    }
+
+    void WetController::NoteWetness(RE::Actor* a, float before, float after) {
+        if (std::abs(after - before) > 1e-4f) _stateDirty = true;
+
+        for (const auto& s : *_subs.load(std::memory_order_acquire)) CheckCrossing(s, a, after);
+
+        const Settings::Config& cfg = *_cfg;
+        if (cfg.modEventThreshold > 0.f && (!cfg.modEventPlayerOnly || a->IsPlayerRef())) {
+            _modEventSub->threshold = std::min(cfg.modEventThreshold, 1.f);
+            _modEventSub->hysteresis = std::clamp(cfg.modEventHysteresis, 0.f, _modEventSub->threshold);
+            CheckCrossing(_modEventSub, a, after);
+        }
+    }
+
+    void WetController::CheckCrossing(const std::shared_ptr<Subscription>& s, RE::Actor* a, float wet) {
+        const std::uint32_t id = a->GetFormID();
+        if (s->formID && s->formID != id) return;
+
+        const bool was = s->above.contains(id);
+        const bool is = was ? wet >= s->threshold - s->hysteresis : wet >= s->threshold;
+        if (is == was) return;
+        if (is)
+            s->above.insert(id);
+        else
+            s->above.erase(id);
+
+        WetnessEvent ev;
+        ev.subscription = s->id;
+        ev.formID = id;
+        ev.wetness = wet;
+        ev.threshold = s->threshold;
+        ev.rising = is ? 1u : 0u;
+        _events.push_back({s, ev, a});
+    }
+
+    void WetController::DispatchWetnessEvents() {
+        if (_stateDirty) {
+            _stateDirty = false;
+            _stateVersion.fetch_add(1, std::memory_order_release);
+        }
+        if (_events.empty()) return;
+
+        // callbacks may subscribe or unsubscribe, so they run on a detached list
+        const std::vector<PendingEvent> events = std::move(_events);
+        _events.clear();
+        const std::uint64_t version = GetStateVersion();
+        for (PendingEvent e : events) {
+            if (!e.sub->active) continue;
+            e.ev.stateVersion = version;
+            if (e.sub == _modEventSub) {
+                SKSE::ModCallbackEvent mod{"SWE_WetnessChanged", e.ev.rising ? "wet" : "dry", e.ev.wetness, e.actor};
+                if (auto* src = SKSE::GetModCallbackEventSource()) src->SendEvent(&mod);
+            } else if (e.sub->cb) {
+                e.sub->cb(&e.ev, e.sub->user);
+            } else if (auto* msg = SKSE::GetMessagingInterface()) {
+                msg->Dispatch(kMsgWetnessCrossed, &e.ev, sizeof(e.ev), nullptr);
+            }
+        }
+    }
+
+    void WetController::PublishSharedTable() {
+        const Settings::Config& cfg = *_cfg;
+        if (!cfg.sharedTableEnabled) {
+            if (SharedTable::IsOpen()) SharedTable::Close();
+            _sharedTableFailed = false;
+            return;
+        }
+        if (_sharedTableFailed) return;
+
+        const auto cap = static_cast<std::uint32_t>(std::clamp(cfg.sharedTableMaxActors, 1, 65536));
+        if (!SharedTable::Open(cap)) {
+            logger::warn("[SWE] Could not create the shared-memory table ({} rows)", cap);
+            _sharedTableFailed = true;
+            return;
+        }
+
+        std::scoped_lock l(_mtx);
+        const double clock = _simClock.load(std::memory_order_relaxed);
+        _sharedRows.clear();
+        _sharedRows.reserve(_wet.size());
+        for (const auto& [id, wd] : _wet) {
+            Shared::Entry& e = _sharedRows.emplace_back();
+            e.formID = id;
+            e.wetness = SettledState(wd, cfg, clock, e.cat);
+            e.envMask = wd.envMask;
+            e.lastSeenMs = Shared::ToMs(wd.lastSeen);
+            e.envMs = wd.envMaskAt.time_since_epoch().count() ? Shared::ToMs(wd.envMaskAt) : 0;
+        }
+        SharedTable::Trim(_sharedRows, cap);
+        SharedTable::Publish(_sharedRows, GetStateVersion());
+    }
+
     void WetController::SetExternalWetness(RE::Actor* a, std::string key, float value, float durationSec) {
         if (!a) return;
         key = NormalizeKey(std::move(key));
         if (key.empty()) return;
         value = clampf(value, 0.f, 1.f);
         std::scoped_lock l(_mtx);
-        auto& wd = _wet[a->GetFormID()];
+        _stateVersion.fetch_add(1, std::memory_order_release);
+        auto& wd = WetOf(a->GetFormID());
         auto& src = wd.extSources[key];
         src.value = value;
         src.expiryRemainingSec = (durationSec > 0.f) ? durationSec : -1.f;
         if (src.catMask == 0) {
             src.catMask = SWE::Papyrus::SWE_CAT_SKIN_FACE;
         }
+        RecordSource(Rec::ExtOp::Set, a->GetFormID(), key, src);
     }
 
     void WetController::SetExternalWetnessMask(RE::Actor* a, const std::string& key, float intensity01,
@@ -1796,20 +2102,22 @@ namespace SWE {
         if (normKey.empty()) return;
 
         std::scoped_lock l(_mtx);
-        auto& wd = _wet[a->GetFormID()];
+        _stateVersion.fetch_add(1, std::memory_order_release);
+        auto& wd = WetOf(a->GetFormID());
 
         ExternalSource& src = wd.extSources[normKey];
         src.value = clampf(intensity01, 0.f, 1.f);
         src.expiryRemainingSec = (durationSec > 0.f) ? durationSec : -1.f;
         src.catMask = static_cast<std::uint8_t>(catMask & SWE::Papyrus::SWE_CAT_MASK_4BIT);
         src.flags = flags;
+        RecordSource(Rec::ExtOp::SetMask, a->GetFormID(), normKey, src);
     }
 
     float WetController::GetBaseWetnessForActor(RE::Actor* a) {
         if (!a) return 0.f;
         std::scoped_lock l(_mtx);
-        auto it = _wet.find(a->GetFormID());
-        return (it != _wet.end()) ? it->second.baseWetness : 0.f;
+        const WetData* wd = FindWet(a->GetFormID());
+        return wd ? wd->baseWetness : 0.f;
     }
 
     void WetController::SetExternalWetnessEx(RE::Actor* a, std::string key, float value, float durationSec,
@@ -1819,12 +2127,14 @@ namespace SWE {
         if (key.empty()) return;
 
         std::scoped_lock l(_mtx);
-        auto& src = _wet[a->GetFormID()].extSources[key];
+        _stateVersion.fetch_add(1, std::memory_order_release);
+        auto& src = WetOf(a->GetFormID()).extSources[key];
         src.value = clampf(value, 0.f, 1.f);
         src.expiryRemainingSec = (durationSec > 0.f) ? durationSec : -1.f;
         src.catMask = static_cast<std::uint8_t>(catMask & SWE::Papyrus::SWE_CAT_MASK_4BIT);
         // Important: do NOT touch src.flags -> keep existing flags
         src.ov = ov;
+        RecordSource(Rec::ExtOp::SetEx, a->GetFormID(), key, src);
     }
 
     void WetController::ClearExternalWetness(RE::Actor* a, std::string key) {
@@ -1832,27 +2142,52 @@ namespace SWE {
         key = NormalizeKey(std::move(key));
         if (key.empty()) return;
         std::scoped_lock l(_mtx);
-        auto itA = _wet.find(a->GetFormID());
-        if (itA == _wet.end()) return;
-        itA->second.extSources.erase(key);
+        WetData* wd = FindWet(a->GetFormID());
+        if (!wd) return;
+        if (wd->extSources.erase(key)) {
+            _stateVersion.fetch_add(1, std::memory_order_release);
+            Rec::External(Rec::ExtOp::Clear, a->GetFormID(), key, 0.f, 0.f, 0, 0);
+        }
+    }
+
+    void WetController::RecordSource(Rec::ExtOp op, std::uint32_t formID, const std::string& key,
+                                     const ExternalSource& src) {
+        if (!Rec::IsRecording()) return;
+        const float ov7[7]{src.ov.maxGloss,   src.ov.maxSpec,   src.ov.minGloss,   src.ov.minSpec,
+                           src.ov.glossBoost, src.ov.specBoost, src.ov.skinHairMul};
+        Rec::External(op, formID, key, src.value, src.expiryRemainingSec, src.catMask, src.flags, ov7);
     }
 
     float WetController::GetExternalWetness(RE::Actor* a, std::string key) {
         if (!a) return 0.f;
         key = NormalizeKey(std::move(key));
         if (key.empty()) return 0.f;
+        const std::uint32_t id = a->GetFormID();
         std::scoped_lock l(_mtx);
-        auto itA = _wet.find(a->GetFormID());
-        if (itA == _wet.end()) return 0.f;
-        auto it = itA->second.extSources.find(key);
-        return (it != itA->second.extSources.end()) ? it->second.value : 0.f;
+        if (auto it = _wet.find(id); it != _wet.end()) {
+            // a timed source that runs out before the sim clock is already gone for the caller
+            const WetData& wd = it->second;
+            const auto src = wd.extSources.find(key);
+            if (src == wd.extSources.end()) return 0.f;
+            const double gap = (wd.simTime < 0.0) ? 0.0 : _simClock.load(std::memory_order_acquire) - wd.simTime;
+            const float remain = src->second.expiryRemainingSec;
+            return (remain >= 0.f && gap >= 1e-3 && remain - gap <= 0.0) ? 0.f : src->second.value;
+        }
+        if (const CoSave::Actor* saved = FindPending(id)) {
+            for (std::uint32_t i = 0; i < saved->sourceCount; ++i) {
+                const CoSave::Source& s = _pending.sources[saved->firstSource + i];
+                if (NormalizeKey(_pending.keys[s.key]) == key) return clampf(s.value, 0.f, 1.f);
+            }
+        }
+        return 0.f;  // cold actors have no sources
     }
 
     float WetController::GetFinalWetnessForActor(RE::Actor* a) {
         if (!a) return 0.f;
+        float wet = 0.f, cat[4];
         std::scoped_lock l(_mtx);
-        auto it = _wet.find(a->GetFormID());
-        return (it != _wet.end()) ? it->second.wetness : 0.f;
+        PeekState(a->GetFormID(), wet, cat);
+        return wet;
     }
 
     /*
@@ -1860,58 +2195,222 @@ namespace SWE {
      * Serialization and Deserialization
      * =================================
      */
-    void WetController::Serialize(SKSE::SerializationInterface* intfc) {
+    // Source keys are matched lowercased and trimmed
+    static void NormalizeSourceKey(std::string& key) {
+        std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return std::tolower(c); });
+        key.erase(key.begin(), std::find_if(key.begin(), key.end(), [](unsigned char c) { return !std::isspace(c); }));
+        key.erase(std::find_if(key.rbegin(), key.rend(), [](unsigned char c) { return !std::isspace(c); }).base(),
+                  key.end());
+    }
+
+    void WetController::AdoptPending(CoSave::Image&& img) {
+        std::ranges::stable_sort(img.actors, {}, &CoSave::Actor::formID);
+        // two saved entries that resolve to the same FormID keep the first
+        const auto dup = std::ranges::unique(img.actors, {}, &CoSave::Actor::formID);
+        img.actors.erase(dup.begin(), dup.end());
+
         std::scoped_lock l(_mtx);
+        _wet.clear();
+        _cold.clear();
+        _pending = std::move(img);
+        _pendingUsed.assign(_pending.actors.size(), false);
+        _pendingLeft = _pending.actors.size();
+    }
 
-        const std::uint32_t magic = 'SWET';
-        intfc->WriteRecordData(&magic, sizeof(magic));
+    const CoSave::Actor* WetController::FindPending(std::uint32_t id) const {
+        if (_pendingLeft == 0) return nullptr;
+        const auto it = std::ranges::lower_bound(_pending.actors, id, {}, &CoSave::Actor::formID);
+        if (it == _pending.actors.end() || it->formID != id) return nullptr;
+        return _pendingUsed[it - _pending.actors.begin()] ? nullptr : std::to_address(it);
+    }
 
-        std::uint32_t count = 0;
-        for (auto& [fid, wd] : _wet) {
-            if (wd.wetness > 0.0005f || !wd.extSources.empty()) ++count;
+    WetController::WetData& WetController::Materialize(const CoSave::Actor& saved) {
+        std::scoped_lock l(_mtx);
+        const std::size_t idx = &saved - _pending.actors.data();
+        _pendingUsed[idx] = true;
+
+        WetData& wd = _wet[saved.formID];
+        wd.wetness = clampf(saved.wetness, 0.f, 1.f);
+        wd.lastAppliedWet = -1.f;
+        // first touched now, whether by the tick, the out-of-range path or an API call; at epoch it would go cold
+        // on the next tier pass and thaw right after
+        wd.lastSeen = std::chrono::steady_clock::now();
+
+        for (std::uint32_t i = 0; i < saved.sourceCount; ++i) {
+            const CoSave::Source& s = _pending.sources[saved.firstSource + i];
+            std::string key = _pending.keys[s.key];
+            NormalizeSourceKey(key);
+
+            ExternalSource& src = wd.extSources[std::move(key)];
+            src.value = clampf(s.value, 0.f, 1.f);
+            src.expiryRemainingSec = s.remainSec;
+            src.catMask = (s.catMask & 0x0F) ? (s.catMask & 0x0F) : 0x0F;
+            src.flags = s.flags;
+            src.ov = {s.ov[0], s.ov[1], s.ov[2], s.ov[3], s.ov[4], s.ov[5], s.ov[6]};
+        }
+
+        // the last one out releases the decoded record (saved points into it)
+        if (--_pendingLeft == 0) {
+            _pending = {};
+            _pendingUsed = {};
         }
-        intfc->WriteRecordData(&count, sizeof(count));
+        return wd;
+    }
+
+    const WetController::ColdActor* WetController::FindCold(std::uint32_t id) const {
+        if (_cold.empty()) return nullptr;
+        const auto it = std::ranges::lower_bound(_cold, id, {}, &ColdActor::formID);
+        return (it != _cold.end() && it->formID == id) ? std::to_address(it) : nullptr;
+    }
+
+    WetController::WetData* WetController::Thaw(std::uint32_t id) {
+        std::scoped_lock l(_mtx);
+        const ColdActor* c = FindCold(id);
+        if (!c) return nullptr;
+
+        WetData& wd = _wet[id];
+        for (int ci = 0; ci < 4; ++ci) wd.simCat[ci] = c->cat[ci] / 255.f;
+        wd.simInit = true;
+        wd.wetness = std::max(std::max(wd.simCat[0], wd.simCat[1]), std::max(wd.simCat[2], wd.simCat[3]));
+        wd.lastSeen = std::chrono::steady_clock::now();  // 3D came back fresh, lastAppliedCat stays -1 so it reapplies
+        // the time it spent unloaded is settled on its next update or API query
+        wd.simTime = c->simSec;
+        wd.envClass = static_cast<EnvClass>(c->env);
+        _cold.erase(_cold.begin() + (c - _cold.data()));
+        return &wd;
+    }
+
+    WetController::WetData* WetController::FindWet(std::uint32_t id) {
+        if (auto it = _wet.find(id); it != _wet.end()) return &it->second;
+        if (const CoSave::Actor* saved = FindPending(id)) return &Materialize(*saved);
+        return Thaw(id);
+    }
+
+    WetController::WetData& WetController::WetOf(std::uint32_t id) {
+        if (WetData* wd = FindWet(id)) return *wd;
+        std::scoped_lock l(_mtx);  // API threads look _wet up under the lock
+        return _wet[id];
+    }
+
+    void WetController::Serialize(SKSE::SerializationInterface* intfc) {
+        std::scoped_lock l(_mtx);
+
+        CoSave::Image img;
+        std::unordered_map<std::string_view, std::uint32_t> keyIndex;
+        auto intern = [&](std::string_view key) {
+            key = key.substr(0, 1024);
+            auto [it, inserted] = keyIndex.try_emplace(key, static_cast<std::uint32_t>(img.keys.size()));
+            if (inserted) img.keys.emplace_back(key);
+            return it->second;
+        };
 
         for (auto& [fid, wd] : _wet) {
             if (wd.wetness <= 0.0005f && wd.extSources.empty()) continue;
 
-            intfc->WriteRecordData(&fid, sizeof(fid));
-
-            // Wetness + lastAppliedWet
-            intfc->WriteRecordData(&wd.wetness, sizeof(wd.wetness));
-            intfc->WriteRecordData(&wd.lastAppliedWet, sizeof(wd.lastAppliedWet));
+            CoSave::Actor& a = img.actors.emplace_back();
+            a.formID = fid;
+            a.wetness = wd.wetness;
+            a.lastAppliedWet = wd.lastAppliedWet;
+            a.firstSource = static_cast<std::uint32_t>(img.sources.size());
+            a.sourceCount = static_cast<std::uint32_t>(std::min<std::size_t>(wd.extSources.size(), 0xFFFF));
 
-            // Externe sources
-            std::uint16_t n = static_cast<std::uint16_t>(std::min<std::size_t>(wd.extSources.size(), 0xFFFF));
-            intfc->WriteRecordData(&n, sizeof(n));
+            std::uint32_t n = 0;
             for (auto& [key, src] : wd.extSources) {
-                std::string k = key;
-                if (k.size() > 1024) k.resize(1024);
-                std::uint16_t klen = static_cast<std::uint16_t>(k.size());
-                intfc->WriteRecordData(&klen, sizeof(klen));
-                if (klen) intfc->WriteRecordData(k.data(), klen);
-
-                intfc->WriteRecordData(&src.value, sizeof(src.value));
-                float remainSec = src.expiryRemainingSec;
-                intfc->WriteRecordData(&remainSec, sizeof(remainSec));
-
-                intfc->WriteRecordData(&src.catMask, sizeof(src.catMask));
-
-                std::uint32_t flags = src.flags;
-                intfc->WriteRecordData(&flags, sizeof(flags));
-
-                intfc->WriteRecordData(&src.ov.maxGloss, sizeof(float));
-                intfc->WriteRecordData(&src.ov.maxSpec, sizeof(float));
-                intfc->WriteRecordData(&src.ov.minGloss, sizeof(float));
-                intfc->WriteRecordData(&src.ov.minSpec, sizeof(float));
-                intfc->WriteRecordData(&src.ov.glossBoost, sizeof(float));
-                intfc->WriteRecordData(&src.ov.specBoost, sizeof(float));
-                intfc->WriteRecordData(&src.ov.skinHairMul, sizeof(float));
+                if (n++ == a.sourceCount) break;
+
+                CoSave::Source& s = img.sources.emplace_back();
+                s.key = intern(key);
+                s.value = src.value;
+                s.remainSec = src.expiryRemainingSec;
+                s.catMask = src.catMask;
+                s.flags = src.flags;
+                const float ov[CoSave::kOverrideCount]{src.ov.maxGloss,   src.ov.maxSpec,   src.ov.minGloss,
+                                                       src.ov.minSpec,    src.ov.glossBoost, src.ov.specBoost,
+                                                       src.ov.skinHairMul};
+                std::copy(std::begin(ov), std::end(ov), s.ov);
+            }
+        }
+
+        // actors restored by the last load that nothing has touched since are written back as they were read
+        if (_pendingLeft) {
+            for (std::size_t pi = 0; pi < _pending.actors.size(); ++pi) {
+                if (_pendingUsed[pi]) continue;
+                const CoSave::Actor& p = _pending.actors[pi];
+                CoSave::Actor& a = img.actors.emplace_back(p);
+                a.firstSource = static_cast<std::uint32_t>(img.sources.size());
+                for (std::uint32_t i = 0; i < p.sourceCount; ++i) {
+                    CoSave::Source& s = img.sources.emplace_back(_pending.sources[p.firstSource + i]);
+                    s.key = intern(_pending.keys[s.key]);
+                }
+            }
+        }
+
+        for (const ColdActor& c : _cold) {
+            CoSave::Actor& a = img.actors.emplace_back();
+            a.formID = c.formID;
+            a.wetness = std::max(std::max(c.cat[0], c.cat[1]), std::max(c.cat[2], c.cat[3])) / 255.f;
+            a.firstSource = static_cast<std::uint32_t>(img.sources.size());
+        }
+
+        const auto cfg = Settings::GetConfig();
+        CoSave::CompactLimits lim;
+        lim.maxActors = static_cast<std::uint32_t>(std::max(0, cfg->saveMaxActors));
+        lim.maxSourcesPerActor = static_cast<std::uint32_t>(std::max(0, cfg->saveMaxSourcesPerActor));
+        lim.keepFlags = SWE::Papyrus::SWE_FLAG_ZERO_BASE;  // acts even at zero intensity
+
+        // Over the actor cap the player is kept first, then loaded actors by distance, then unloaded ones by how
+        // long ago the tick last saw them; states restored by the load and never touched since go last.
+        const RE::Actor* player = RE::PlayerCharacter::GetSingleton();
+        const auto now = std::chrono::steady_clock::now();
+        auto rank = [&](std::uint32_t fid) -> double {
+            constexpr double kUnloaded = 1e9;
+            if (player && fid == player->GetFormID()) return -1.0;
+            auto it = _wet.find(fid);
+            if (it == _wet.end()) {
+                const ColdActor* c = FindCold(fid);
+                return c ? kUnloaded + (SteadySeconds(now) - c->lastSeenSec) : std::numeric_limits<double>::max();
             }
+            const auto* a = RE::TESForm::LookupByID<RE::Actor>(fid);
+            if (a && player && a->Is3DLoaded()) return a->GetPosition().GetDistance(player->GetPosition());
+            return kUnloaded + std::chrono::duration<double>(now - it->second.lastSeen).count();
+        };
+        const CoSave::CompactStats st = CoSave::Compact(img, lim, rank);
+
+        std::vector<std::uint8_t> buf;
+        CoSave::Encode(img, buf);
+        intfc->WriteRecordData(buf.data(), static_cast<std::uint32_t>(buf.size()));
+        logger::info("[SWE] co-save: {} actors, {} sources, {} bytes (dropped {} actors, {} sources, {} bytes)",
+                     img.actors.size(), img.sources.size(), buf.size(), st.actorsDropped, st.sourcesDropped,
+                     st.bytesSaved);
+    }
+
+    void WetController::DeserializeV6(SKSE::SerializationInterface* intfc, std::uint32_t length) {
+        std::vector<std::uint8_t> buf(length);
+        if (length && intfc->ReadRecordData(buf.data(), length) != length) {
+            logger::warn("[SWE] co-save: truncated record, wetness state not restored");
+            return;
+        }
+        CoSave::Image img;
+        if (!CoSave::Decode(buf, img)) {
+            logger::warn("[SWE] co-save: corrupt record (checksum or layout), wetness state not restored");
+            return;
+        }
+
+        // FormIDs can only be resolved while the interface is valid; everything else waits for the actor's first use
+        std::size_t kept = 0;
+        for (auto& a : img.actors) {
+            if (intfc->ResolveFormID(a.formID, a.formID)) img.actors[kept++] = a;
         }
+        img.actors.resize(kept);
+
+        AdoptPending(std::move(img));
     }
 
     void WetController::Deserialize(SKSE::SerializationInterface* intfc, std::uint32_t version, std::uint32_t length) {
+        if (version >= 6) {
+            DeserializeV6(intfc, length);
+            return;
+        }
         if (version == 1) {
             float playerWet = 0.0f;
             if (length >= sizeof(float)) {
@@ -1931,9 +2430,7 @@ namespace SWE {
         std::uint32_t count = 0;
         if (!read(&count, sizeof(count))) return;
 
-        std::scoped_lock l(_mtx);
-        _wet.clear();
-
+        CoSave::Image img;
         for (std::uint32_t i = 0; i < count; ++i) {
             std::uint32_t oldFID = 0;
             if (!read(&oldFID, sizeof(oldFID))) break;
@@ -1974,9 +2471,10 @@ namespace SWE {
             std::uint16_t nsrc = 0;
             if (!read(&wet, sizeof(wet)) || !read(&last, sizeof(last)) || !read(&nsrc, sizeof(nsrc))) break;
 
-            WetData wd{};
-            wd.wetness = clampf(wet, 0.f, 1.f);
-            wd.lastAppliedWet = -1.f;
+            CoSave::Actor& saved = img.actors.emplace_back();
+            saved.formID = newFID;
+            saved.wetness = wet;
+            saved.firstSource = static_cast<std::uint32_t>(img.sources.size());
 
             for (std::uint16_t s = 0; s < nsrc; ++s) {
                 std::uint16_t klen = 0;
@@ -1986,71 +2484,33 @@ namespace SWE {
                     key.resize(klen);
                     if (!read(key.data(), klen)) break;
                 }
-                std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return std::tolower(c); });
-                key.erase(key.begin(),
-                          std::find_if(key.begin(), key.end(), [](unsigned char c) { return !std::isspace(c); }));
-                key.erase(
-                    std::find_if(key.rbegin(), key.rend(), [](unsigned char c) { return !std::isspace(c); }).base(),
-                    key.end());
-
-                ExternalSource src{};
 
-                float v = 0.f;
-                if (!read(&v, sizeof(v))) break;
-                src.value = clampf(v, 0.f, 1.f);
+                CoSave::Source src{};
+                if (!read(&src.value, sizeof(src.value))) break;
 
                 float expLike = -1.f;
                 if (!read(&expLike, sizeof(expLike))) break;
-
-                std::uint8_t mask = 0x0F;
-                if (!read(&mask, sizeof(mask))) break;
-                src.catMask = (mask & 0x0F) ? (mask & 0x0F) : 0x0F;
-
-                if (version >= 5) {
-                    std::uint32_t f = 0;
-                    if (!read(&f, sizeof(f))) break;
-                    src.flags = f;
-                } else {
-                    src.flags = 0;
-                }
+                if (!read(&src.catMask, sizeof(src.catMask))) break;
+                if (version >= 5 && !read(&src.flags, sizeof(src.flags))) break;
 
                 if (version >= 4) {
-                    src.expiryRemainingSec = expLike;
+                    src.remainSec = expLike;
                 } else {
                     const float nowH = GetGameHours();
-                    if (expLike >= 0.f)
-                        src.expiryRemainingSec = std::max(0.f, (expLike - nowH) * 3600.f);
-                    else
-                        src.expiryRemainingSec = -1.f;
+                    src.remainSec = (expLike >= 0.f) ? std::max(0.f, (expLike - nowH) * 3600.f) : -1.f;
                 }
 
-                if (version >= 3) {
-                    float ftmp;
-                    if (!read(&ftmp, sizeof(float))) break;
-                    src.ov.maxGloss = ftmp;
-                    if (!read(&ftmp, sizeof(float))) break;
-                    src.ov.maxSpec = ftmp;
-                    if (!read(&ftmp, sizeof(float))) break;
-                    src.ov.minGloss = ftmp;
-                    if (!read(&ftmp, sizeof(float))) break;
-                    src.ov.minSpec = ftmp;
-                    if (!read(&ftmp, sizeof(float))) break;
-                    src.ov.glossBoost = ftmp;
-                    if (!read(&ftmp, sizeof(float))) break;
-                    src.ov.specBoost = ftmp;
-                    if (!read(&ftmp, sizeof(float))) break;
-                    src.ov.skinHairMul = ftmp;
-                } else {
-                    src.ov = {};
-                }
+                // the seven overrides are stored back to back in OverrideParams order
+                if (version >= 3 && !read(src.ov, sizeof(src.ov))) break;
 
-                wd.extSources[key] = std::move(src);
+                src.key = static_cast<std::uint32_t>(img.keys.size());
+                img.keys.push_back(std::move(key));
+                img.sources.push_back(src);
+                ++saved.sourceCount;
             }
-
-            _wet[newFID] = std::move(wd);
         }
 
-        SKSE::GetTaskInterface()->AddTask([this]() { this->RefreshNow(); });
+        AdoptPending(std::move(img));
     }
 
 }
\ No newline at end of file
@@ -0,0 +1,166 @@
+#include "utils/Classify.h"
+
+namespace SWE::Classify {
+
+    namespace {
+        // what std::tolower does in the "C" locale, without the call
+        inline char Lower(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+        // Any name from first up to limit levels up
+        template <class Fn>
+        bool AnyUp(std::span<const std::string_view> names, std::size_t first, std::size_t limit, Fn&& fn) {
+            for (std::size_t i = first; i < names.size() && i < first + limit; ++i)
+                if (fn(names[i])) return true;
+            return false;
+        }
+
+        std::string_view FilenameNoExt(std::string_view path) {
+            const std::size_t slash = path.find_last_of('/');
+            const std::string_view file = (slash == std::string_view::npos) ? path : path.substr(slash + 1);
+            const std::size_t dot = file.find_last_of('.');
+            return (dot == std::string_view::npos) ? file : file.substr(0, dot);
+        }
+
+        // token ends the file name and is its own word (start, or after _ - .)
+        bool HasSuffixToken(std::string_view path, std::string_view token) {
+            const std::string_view base = FilenameNoExt(path);
+            if (base.size() < token.size()) return false;
+            const std::size_t pos = base.size() - token.size();
+            if (base.substr(pos) != token) return false;
+            if (pos == 0) return true;
+            const char prev = base[pos - 1];
+            return prev == '_' || prev == '-' || prev == '.';
+        }
+
+        bool Contains(std::string_view s, std::string_view w) { return s.find(w) != std::string_view::npos; }
+    }
+
+    bool ContainsCI(std::string_view hay, std::string_view needle) {
+        if (needle.empty()) return true;
+        if (hay.size() < needle.size()) return false;
+        const char first = Lower(needle[0]);
+        for (std::size_t i = 0, last = hay.size() - needle.size(); i <= last; ++i) {
+            if (Lower(hay[i]) != first) continue;
+            std::size_t j = 1;
+            while (j < needle.size() && Lower(hay[i + j]) == Lower(needle[j])) ++j;
+            if (j == needle.size()) return true;
+        }
+        return false;
+    }
+
+    NormPath::NormPath(std::string_view path) {
+        char* out = _inline;
+        if (path.size() > kInline) {
+            _spill.resize(path.size());
+            out = _spill.data();
+        }
+        std::size_t n = 0;
+        for (char c : path) {
+            c = (c == '\\') ? '/' : Lower(c);
+            if (c == '/' && n && out[n - 1] == '/') continue;
+            out[n++] = c;
+        }
+        _view = std::string_view(out, n);
+    }
+
+    bool StrongPBRSignal(std::string_view p) {
+        if (Contains(p, "/pbr/") || Contains(p, "_pbr") || Contains(p, "/pbr_")) return true;
+
+        if (HasSuffixToken(p, "orm") || HasSuffixToken(p, "rma") || HasSuffixToken(p, "rmao") ||
+            HasSuffixToken(p, "rmaos") || HasSuffixToken(p, "rmos") || HasSuffixToken(p, "mrao") ||
+            HasSuffixToken(p, "maos"))
+            return true;
+
+        return Contains(p, "roughness") || Contains(p, "rough") || Contains(p, "metalness") ||
+               Contains(p, "metallic") || Contains(p, "metal");
+    }
+
+    bool HasAmbiguousPSuffix(std::string_view p) { return HasSuffixToken(p, "p"); }
+
+    bool TexturesLookPBR(std::span<const char* const> paths) {
+        for (const char* raw : paths) {
+            if (!raw || !raw[0]) continue;
+            const NormPath p(raw);
+            if (StrongPBRSignal(p.view())) return true;
+        }
+        return false;
+    }
+
+    bool BodySkinTextures(const char* diffuse, const char* normal) {
+        // raw paths: the game keeps backslashes, so "actors/character" only matches paths written with '/'
+        const std::string_view dn[2]{diffuse ? diffuse : "", normal ? normal : ""};
+        auto has = [&](std::string_view needle) { return ContainsCI(dn[0], needle) || ContainsCI(dn[1], needle); };
+
+        const bool inActors = has("actors/character");
+        const bool skinish = has("body") || has("hand") || has("feet") || has("skin");
+        const bool armorish = has("armor/") || has("clothes/");
+        return inActors && skinish && !armorish;
+    }
+
+    bool BodySkinName(std::string_view n) {
+        // "hands" and "femalebody" / "malebody" are covered by "hand" and "body"
+        const bool isSkiny = ContainsCI(n, "body") || ContainsCI(n, "hand") || ContainsCI(n, "feet") ||
+                             ContainsCI(n, "foot") || ContainsCI(n, "skin");
+        if (!isSkiny) return false;
+        return !(ContainsCI(n, "armor") || ContainsCI(n, "cuirass") || ContainsCI(n, "gauntlet") ||
+                 ContainsCI(n, "glove") || ContainsCI(n, "boot") || ContainsCI(n, "shoe") || ContainsCI(n, "robe"));
+    }
+
+    bool HeatSourceName(std::string_view n) {
+        if (ContainsCI(n, "campfire") || ContainsCI(n, "fireplace") || ContainsCI(n, "brazier") ||
+            ContainsCI(n, "hearth") || ContainsCI(n, "embers") || ContainsCI(n, "forge") || ContainsCI(n, "smelter"))
+            return true;
+        return ContainsCI(n, "fire") && !ContainsCI(n, "torch") && !ContainsCI(n, "candle");
+    }
+
+    bool WorkFurnitureEditorID(std::string_view ed) {
+        // "chopping" also covers "choppingblock"
+        static constexpr std::string_view kKeys[] = {"workbench", "forge",   "smelter", "grindstone", "tanning",
+                                                     "alchemy",   "enchant", "cooking", "chopping",   "sawmill",
+                                                     "mine",      "mining",  "ore",     "blacksmith"};
+        for (const std::string_view k : kKeys)
+            if (ContainsCI(ed, k)) return true;
+        return false;
+    }
+
+    MatCat ClassifyGeom(const Geom& g) {
+        if (g.faceGen) return MatCat::SkinFace;
+        if (g.hairTint) return MatCat::Hair;
+
+        for (const std::uint16_t slot : g.slots) {
+            switch (slot) {
+                case 30:
+                    return MatCat::SkinFace;
+                case 31:
+                    return MatCat::Hair;
+                case 41:
+                    return MatCat::Weapon;
+                case 32:
+                case 33:
+                case 37:
+                    if (BodySkinTextures(g.diffuse, g.normal) || AnyUp(g.names, 0, 4, BodySkinName))
+                        return MatCat::SkinFace;
+                    return MatCat::ArmorClothing;
+                case 34:
+                case 35:
+                case 36:
+                case 38:
+                case 39:
+                case 40:
+                    return MatCat::ArmorClothing;
+                default:
+                    break;
+            }
+        }
+
+        for (std::size_t i = 0; i < g.names.size() && i < 4; ++i) {
+            const std::string_view n = g.names[i];
+            if (ContainsCI(n, "hair")) return MatCat::Hair;
+            if (ContainsCI(n, "head") || ContainsCI(n, "face")) return MatCat::SkinFace;
+            if (AnyUp(g.names, i, 4, BodySkinName)) return MatCat::SkinFace;
+            if (ContainsCI(n, "weapon") || ContainsCI(n, "sword") || ContainsCI(n, "bow") || ContainsCI(n, "dagger"))
+                return MatCat::Weapon;
+        }
+        return MatCat::ArmorClothing;
+    }
+}
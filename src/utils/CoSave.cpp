@@ -0,0 +1,290 @@
+#include "utils/CoSave.h"
+
+namespace SWE::CoSave {
+
+    namespace {
+        constexpr std::uint32_t kFnvOffset = 2166136261u;
+        constexpr std::uint32_t kFnvPrime = 16777619u;
+
+        std::uint32_t Fnv1a(std::span<const std::uint8_t> data) {
+            std::uint32_t h = kFnvOffset;
+            for (const std::uint8_t b : data) h = (h ^ b) * kFnvPrime;
+            return h;
+        }
+
+        class Writer {
+        public:
+            explicit Writer(std::vector<std::uint8_t>& out) : _out(out) {}
+
+            void U8(std::uint8_t v) { _out.push_back(v); }
+            void Var(std::uint32_t v) {
+                while (v >= 0x80) {
+                    _out.push_back(static_cast<std::uint8_t>(v | 0x80));
+                    v >>= 7;
+                }
+                _out.push_back(static_cast<std::uint8_t>(v));
+            }
+            template <class T>
+            void Raw(const T& v) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                const std::size_t at = _out.size();
+                _out.resize(at + sizeof(T));
+                std::memcpy(_out.data() + at, &v, sizeof(T));
+            }
+            void Bytes(std::string_view s) { _out.insert(_out.end(), s.begin(), s.end()); }
+
+        private:
+            std::vector<std::uint8_t>& _out;
+        };
+
+        std::size_t VarSize(std::uint32_t v) {
+            std::size_t n = 1;
+            while (v >= 0x80) {
+                v >>= 7;
+                ++n;
+            }
+            return n;
+        }
+
+        std::size_t SourceSize(const Source& s) {
+            std::size_t n = VarSize(s.key) + 2 * sizeof(float) + 1 + VarSize(s.flags) + 1;
+            for (const float o : s.ov)
+                if (o != kOverrideUnset) n += sizeof(float);
+            return n;
+        }
+
+        // Stronger sources first: higher value, then permanent, then the one that lasts longer
+        bool Stronger(const Source& a, const Source& b) {
+            if (a.value != b.value) return a.value > b.value;
+            if ((a.remainSec < 0.f) != (b.remainSec < 0.f)) return a.remainSec < 0.f;
+            return a.remainSec > b.remainSec;
+        }
+
+        class Reader {
+        public:
+            explicit Reader(std::span<const std::uint8_t> in) : _in(in) {}
+
+            bool U8(std::uint8_t& v) {
+                if (_pos >= _in.size()) return false;
+                v = _in[_pos++];
+                return true;
+            }
+            bool Var(std::uint32_t& v) {
+                v = 0;
+                for (unsigned shift = 0; shift < 35; shift += 7) {
+                    std::uint8_t b;
+                    if (!U8(b)) return false;
+                    v |= static_cast<std::uint32_t>(b & 0x7F) << shift;
+                    if (!(b & 0x80)) return true;
+                }
+                return false;
+            }
+            template <class T>
+            bool Raw(T& v) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                if (_in.size() - _pos < sizeof(T)) return false;
+                std::memcpy(&v, _in.data() + _pos, sizeof(T));
+                _pos += sizeof(T);
+                return true;
+            }
+            bool Bytes(std::string& s, std::uint32_t n) {
+                if (_in.size() - _pos < n) return false;
+                s.assign(reinterpret_cast<const char*>(_in.data() + _pos), n);
+                _pos += n;
+                return true;
+            }
+            std::size_t Remaining() const { return _in.size() - _pos; }
+
+        private:
+            std::span<const std::uint8_t> _in;
+            std::size_t _pos{0};
+        };
+    }
+
+    CompactStats Compact(Image& img, const CompactLimits& lim, const std::function<double(std::uint32_t)>& rank) {
+        CompactStats st;
+        const std::size_t before = EncodedSize(img);
+
+        auto live = [&](const Source& s) {
+            if (s.remainSec >= 0.f && s.remainSec < lim.minRemainSec) return false;
+            return s.value > lim.minValue || (s.flags & lim.keepFlags) != 0;
+        };
+
+        Image out;
+        out.actors.reserve(img.actors.size());
+        out.sources.reserve(img.sources.size());
+        for (Actor a : img.actors) {
+            const std::size_t first = out.sources.size();
+            for (std::uint32_t i = 0; i < a.sourceCount; ++i) {
+                const Source& s = img.sources[a.firstSource + i];
+                if (live(s)) out.sources.push_back(s);
+            }
+            std::size_t kept = out.sources.size() - first;
+            if (lim.maxSourcesPerActor && kept > lim.maxSourcesPerActor) {
+                const auto begin = out.sources.begin() + static_cast<std::ptrdiff_t>(first);
+                std::partial_sort(begin, begin + lim.maxSourcesPerActor, out.sources.end(), Stronger);
+                kept = lim.maxSourcesPerActor;
+                out.sources.resize(first + kept);
+            }
+            st.sourcesDropped += a.sourceCount - static_cast<std::uint32_t>(kept);
+
+            if (kept == 0 && a.wetness <= lim.minValue) {
+                ++st.actorsDropped;
+                continue;
+            }
+            a.firstSource = static_cast<std::uint32_t>(first);
+            a.sourceCount = static_cast<std::uint32_t>(kept);
+            out.actors.push_back(a);
+        }
+
+        if (lim.maxActors && out.actors.size() > lim.maxActors) {
+            std::vector<std::pair<double, std::uint32_t>> order;
+            order.reserve(out.actors.size());
+            for (std::uint32_t i = 0; i < out.actors.size(); ++i) order.emplace_back(rank(out.actors[i].formID), i);
+            std::nth_element(order.begin(), order.begin() + lim.maxActors, order.end());
+            order.resize(lim.maxActors);
+
+            std::vector<Actor> actors;
+            std::vector<Source> sources;
+            actors.reserve(order.size());
+            for (const auto& [r, i] : order) {
+                Actor a = out.actors[i];
+                const auto src = out.sources.begin() + a.firstSource;
+                a.firstSource = static_cast<std::uint32_t>(sources.size());
+                sources.insert(sources.end(), src, src + a.sourceCount);
+                actors.push_back(a);
+            }
+            st.actorsDropped += static_cast<std::uint32_t>(out.actors.size() - actors.size());
+            st.sourcesDropped += static_cast<std::uint32_t>(out.sources.size() - sources.size());
+            out.actors = std::move(actors);
+            out.sources = std::move(sources);
+        }
+
+        // re-index the keys that are still referenced
+        std::vector<std::uint32_t> remap(img.keys.size(), UINT32_MAX);
+        for (Source& s : out.sources) {
+            if (remap[s.key] == UINT32_MAX) {
+                remap[s.key] = static_cast<std::uint32_t>(out.keys.size());
+                out.keys.push_back(std::move(img.keys[s.key]));
+            }
+            s.key = remap[s.key];
+        }
+
+        img = std::move(out);
+        st.bytesSaved = before - EncodedSize(img);
+        return st;
+    }
+
+    std::size_t EncodedSize(const Image& img) {
+        std::size_t n = sizeof(kMagic) + VarSize(static_cast<std::uint32_t>(img.keys.size()));
+        for (const auto& k : img.keys) n += VarSize(static_cast<std::uint32_t>(k.size())) + k.size();
+
+        std::vector<std::uint32_t> ids;
+        ids.reserve(img.actors.size());
+        for (const auto& a : img.actors) {
+            ids.push_back(a.formID);
+            n += 2 * sizeof(float) + VarSize(a.sourceCount);
+            for (std::uint32_t i = 0; i < a.sourceCount; ++i) n += SourceSize(img.sources[a.firstSource + i]);
+        }
+        std::sort(ids.begin(), ids.end());
+        n += VarSize(static_cast<std::uint32_t>(ids.size()));
+        std::uint32_t prevID = 0;
+        for (const std::uint32_t id : ids) {
+            n += VarSize(id - prevID);
+            prevID = id;
+        }
+
+        return n + sizeof(std::uint32_t);
+    }
+
+    void Encode(Image& img, std::vector<std::uint8_t>& out) {
+        std::sort(img.actors.begin(), img.actors.end(),
+                  [](const Actor& a, const Actor& b) { return a.formID < b.formID; });
+
+        const std::size_t start = out.size();
+        out.reserve(start + EncodedSize(img));
+        Writer w(out);
+
+        w.Raw(kMagic);
+
+        w.Var(static_cast<std::uint32_t>(img.keys.size()));
+        for (const auto& k : img.keys) {
+            w.Var(static_cast<std::uint32_t>(k.size()));
+            w.Bytes(k);
+        }
+
+        w.Var(static_cast<std::uint32_t>(img.actors.size()));
+        std::uint32_t prevID = 0;
+        for (const auto& a : img.actors) {
+            w.Var(a.formID - prevID);
+            prevID = a.formID;
+            w.Raw(a.wetness);
+            w.Raw(a.lastAppliedWet);
+            w.Var(a.sourceCount);
+
+            for (std::uint32_t i = 0; i < a.sourceCount; ++i) {
+                const Source& s = img.sources[a.firstSource + i];
+                w.Var(s.key);
+                w.Raw(s.value);
+                w.Raw(s.remainSec);
+                w.U8(s.catMask);
+                w.Var(s.flags);
+
+                std::uint8_t present = 0;
+                for (std::size_t o = 0; o < kOverrideCount; ++o)
+                    if (s.ov[o] != kOverrideUnset) present |= static_cast<std::uint8_t>(1u << o);
+                w.U8(present);
+                for (std::size_t o = 0; o < kOverrideCount; ++o)
+                    if (present & (1u << o)) w.Raw(s.ov[o]);
+            }
+        }
+
+        w.Raw(Fnv1a(std::span<const std::uint8_t>(out).subspan(start)));
+    }
+
+    bool Decode(std::span<const std::uint8_t> in, Image& img) {
+        img.clear();
+        if (in.size() < 2 * sizeof(std::uint32_t)) return false;
+
+        const auto body = in.first(in.size() - sizeof(std::uint32_t));
+        std::uint32_t sum = 0;
+        std::memcpy(&sum, in.data() + body.size(), sizeof(sum));
+        if (Fnv1a(body) != sum) return false;
+
+        Reader r(body);
+        std::uint32_t magic = 0;
+        if (!r.Raw(magic) || magic != kMagic) return false;
+
+        std::uint32_t keyCount = 0;
+        if (!r.Var(keyCount) || keyCount > r.Remaining()) return false;
+        img.keys.resize(keyCount);
+        for (auto& k : img.keys) {
+            std::uint32_t len = 0;
+            if (!r.Var(len) || !r.Bytes(k, len)) return false;
+        }
+
+        std::uint32_t actorCount = 0;
+        if (!r.Var(actorCount) || actorCount > r.Remaining()) return false;
+        img.actors.resize(actorCount);
+        std::uint32_t prevID = 0;
+        for (auto& a : img.actors) {
+            std::uint32_t delta = 0;
+            if (!r.Var(delta) || !r.Raw(a.wetness) || !r.Raw(a.lastAppliedWet) || !r.Var(a.sourceCount)) return false;
+            a.formID = prevID + delta;
+            prevID = a.formID;
+            if (a.sourceCount > r.Remaining()) return false;
+
+            a.firstSource = static_cast<std::uint32_t>(img.sources.size());
+            for (std::uint32_t i = 0; i < a.sourceCount; ++i) {
+                Source& s = img.sources.emplace_back();
+                std::uint8_t present = 0;
+                if (!r.Var(s.key) || s.key >= keyCount || !r.Raw(s.value) || !r.Raw(s.remainSec) ||
+                    !r.U8(s.catMask) || !r.Var(s.flags) || !r.U8(present))
+                    return false;
+                for (std::size_t o = 0; o < kOverrideCount; ++o)
+                    if ((present & (1u << o)) && !r.Raw(s.ov[o])) return false;
+            }
+        }
+        return r.Remaining() == 0;
+    }
+}
@@ -0,0 +1,367 @@
+#include "utils/InputRecorder.h"
+
+namespace SWE::Rec {
+
+    namespace {
+        constexpr std::size_t kFlushBytes = 64 * 1024;
+
+        std::atomic<bool> g_recording{false};
+        std::mutex g_mtx;
+        std::ofstream g_out;
+        std::vector<char> g_buf;
+        std::uint64_t g_records{0};
+        std::atomic<std::uint32_t> g_session{0};
+        // versions written last; Start forgets them so every recording opens with both
+        std::optional<std::uint64_t> g_configVersion, g_listsVersion;
+
+        template <class T>
+        void Put(const T& v) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            const auto* p = reinterpret_cast<const char*>(&v);
+            g_buf.insert(g_buf.end(), p, p + sizeof(T));
+        }
+
+        void PutString(std::string_view str) {
+            const auto len = static_cast<std::uint16_t>(std::min<std::size_t>(str.size(), UINT16_MAX));
+            Put(len);
+            g_buf.insert(g_buf.end(), str.data(), str.data() + len);
+        }
+
+        template <class T>
+        constexpr char TypeTag() {
+            if constexpr (std::is_same_v<T, bool>)
+                return 'b';
+            else if constexpr (std::is_same_v<T, int>)
+                return 'i';
+            else
+                return 'f';
+        }
+
+        void FlushIfNeeded(bool force) {
+            if (g_buf.empty() || (!force && g_buf.size() < kFlushBytes)) return;
+            g_out.write(g_buf.data(), static_cast<std::streamsize>(g_buf.size()));
+            g_buf.clear();
+        }
+
+        template <class T>
+        bool Get(std::istream& is, T& v) {
+            return static_cast<bool>(is.read(reinterpret_cast<char*>(&v), sizeof(T)));
+        }
+
+        template <class Len>
+        bool GetString(std::istream& is, std::string& str) {
+            Len len = 0;
+            if (!Get(is, len)) return false;
+            str.resize(len);
+            return len == 0 || static_cast<bool>(is.read(str.data(), len));
+        }
+
+        bool GetConfig(std::istream& is, Settings::Config& cfg) {
+            cfg = {};
+            std::uint16_t count = 0;
+            if (!Get(is, cfg.version) || !Get(is, count)) return false;
+            for (std::uint16_t i = 0; i < count; ++i) {
+                char type = 0;
+                std::string name;
+                std::uint32_t bits = 0;
+                if (!Get(is, type) || !GetString<std::uint8_t>(is, name) || !Get(is, bits)) return false;
+    #define SWE_READ_SETTING(T, n, init, reset)                                   \
+                if (name == #n && type == TypeTag<T>()) {                         \
+                    if constexpr (std::is_same_v<T, bool>)                        \
+                        cfg.n = bits != 0;                                        \
+                    else                                                          \
+                        std::memcpy(&cfg.n, &bits, sizeof(cfg.n));                \
+                    continue;                                                     \
+                }
+                SWE_SETTINGS(SWE_READ_SETTING)
+    #undef SWE_READ_SETTING
+            }
+            Settings::DeriveConfig(cfg);
+            return true;
+        }
+
+        bool GetFormSpecs(std::istream& is, std::vector<Settings::FormSpec>& out) {
+            std::uint32_t n = 0;
+            if (!Get(is, n)) return false;
+            out.clear();
+            for (std::uint32_t i = 0; i < n; ++i) {
+                Settings::FormSpec fs;
+                std::uint8_t enabled = 0, autoWet = 0;
+                if (!GetString<std::uint16_t>(is, fs.plugin) || !Get(is, fs.id) || !Get(is, fs.value) ||
+                    !Get(is, enabled) || !Get(is, fs.mask) || !Get(is, autoWet)) {
+                    return false;
+                }
+                fs.enabled = enabled != 0;
+                fs.autoWet = autoWet != 0;
+                out.push_back(std::move(fs));
+            }
+            return true;
+        }
+
+        bool GetLists(std::istream& is, Settings::ActorListsSnapshot& lists) {
+            std::uint32_t n = 0;
+            if (!Get(is, lists.version) || !GetFormSpecs(is, lists.overrides) || !GetFormSpecs(is, lists.tracked) ||
+                !Get(is, n)) {
+                return false;
+            }
+            lists.enabledIDs.clear();
+            for (std::uint32_t i = 0; i < n; ++i) {
+                std::uint32_t id = 0;
+                if (!Get(is, id)) return false;
+                lists.enabledIDs.insert(id);
+            }
+            return true;
+        }
+
+        bool GetState(std::istream& is, StateRec& st) {
+            std::uint8_t simInit = 0;
+            std::uint16_t n = 0;
+            if (!(Get(is, st.formID) && Get(is, st.wetness) && Get(is, st.lastAppliedWet) &&
+                  Get(is, st.lastAppliedCat) && Get(is, st.simCat) && Get(is, simInit) && Get(is, st.activityLevel) &&
+                  Get(is, st.simAge) && Get(is, st.envClass) && Get(is, n))) {
+                return false;
+            }
+            st.simInit = simInit != 0;
+            st.sources.resize(n);
+            for (auto& src : st.sources) {
+                if (!(GetString<std::uint16_t>(is, src.key) && Get(is, src.value) &&
+                      Get(is, src.expiryRemainingSec) && Get(is, src.catMask) && Get(is, src.flags))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void PutFormSpecs(const std::vector<Settings::FormSpec>& specs) {
+            Put(static_cast<std::uint32_t>(specs.size()));
+            for (const auto& fs : specs) {
+                PutString(fs.plugin);
+                Put(fs.id);
+                Put(fs.value);
+                Put(static_cast<std::uint8_t>(fs.enabled));
+                Put(fs.mask);
+                Put(static_cast<std::uint8_t>(fs.autoWet));
+            }
+        }
+    }
+
+    bool IsRecording() noexcept { return g_recording.load(std::memory_order_relaxed); }
+
+    bool Start(const std::filesystem::path& path) {
+        std::scoped_lock l(g_mtx);
+        if (g_recording.load()) return true;
+
+        g_out.open(path, std::ios::binary | std::ios::trunc);
+        if (!g_out) {
+            logger::warn("[SWE] rec: could not open {}", path.string());
+            return false;
+        }
+        g_buf.clear();
+        g_buf.reserve(kFlushBytes + 256);
+        g_buf.insert(g_buf.end(), std::begin(kMagic), std::end(kMagic));
+        Put(kVersion);
+        g_records = 0;
+        g_configVersion.reset();
+        g_listsVersion.reset();
+        g_session.fetch_add(1);
+        g_recording.store(true);
+        logger::info("[SWE] rec: recording inputs to {}", path.string());
+        return true;
+    }
+
+    void Stop() {
+        std::scoped_lock l(g_mtx);
+        if (!g_recording.exchange(false)) return;
+        FlushIfNeeded(true);
+        g_out.close();
+        g_buf = {};
+        logger::info("[SWE] rec: stopped after {} records", g_records);
+    }
+
+    std::uint32_t Session() noexcept { return g_session.load(std::memory_order_relaxed); }
+
+    void Config(const Settings::Config& cfg) {
+        if (!IsRecording()) return;
+        std::scoped_lock l(g_mtx);
+        if (!g_recording.load() || g_configVersion == cfg.version) return;
+        g_configVersion = cfg.version;
+        Put('C');
+        Put(cfg.version);
+        std::uint16_t count = 0;
+    #define SWE_COUNT_SETTING(T, name, init, reset) ++count;
+        SWE_SETTINGS(SWE_COUNT_SETTING)
+    #undef SWE_COUNT_SETTING
+        Put(count);
+    #define SWE_WRITE_SETTING(T, name, init, reset)                                                     \
+        {                                                                                               \
+            constexpr std::string_view n = #name;                                                       \
+            std::uint32_t bits = 0;                                                                     \
+            if constexpr (std::is_same_v<T, bool>)                                                      \
+                bits = cfg.name ? 1u : 0u;                                                              \
+            else                                                                                        \
+                std::memcpy(&bits, &cfg.name, sizeof(cfg.name));                                        \
+            Put(TypeTag<T>());                                                                          \
+            Put(static_cast<std::uint8_t>(n.size()));                                                   \
+            g_buf.insert(g_buf.end(), n.begin(), n.end());                                              \
+            Put(bits);                                                                                  \
+        }
+        SWE_SETTINGS(SWE_WRITE_SETTING)
+    #undef SWE_WRITE_SETTING
+        ++g_records;
+        FlushIfNeeded(false);
+    }
+
+    void ActorLists(const Settings::ActorListsSnapshot& lists) {
+        if (!IsRecording()) return;
+        std::scoped_lock l(g_mtx);
+        if (!g_recording.load() || g_listsVersion == lists.version) return;
+        g_listsVersion = lists.version;
+        Put('L');
+        Put(lists.version);
+        PutFormSpecs(lists.overrides);
+        PutFormSpecs(lists.tracked);
+        Put(static_cast<std::uint32_t>(lists.enabledIDs.size()));
+        for (std::uint32_t id : lists.enabledIDs) Put(id);
+        ++g_records;
+        FlushIfNeeded(false);
+    }
+
+    void Tick(float dt, float gameSecDelta, float stepDt) {
+        if (!IsRecording()) return;
+        std::scoped_lock l(g_mtx);
+        if (!g_recording.load()) return;
+        Put('T');
+        Put(dt);
+        Put(gameSecDelta);
+        Put(stepDt);
+        ++g_records;
+        FlushIfNeeded(false);
+    }
+
+    void State(std::uint32_t formID, const StateRec& st) {
+        if (!IsRecording()) return;
+        std::scoped_lock l(g_mtx);
+        if (!g_recording.load()) return;
+        Put('S');
+        Put(formID);
+        Put(st.wetness);
+        Put(st.lastAppliedWet);
+        Put(st.lastAppliedCat);
+        Put(st.simCat);
+        Put(static_cast<std::uint8_t>(st.simInit));
+        Put(st.activityLevel);
+        Put(st.simAge);
+        Put(st.envClass);
+        const auto n = static_cast<std::uint16_t>(std::min<std::size_t>(st.sources.size(), UINT16_MAX));
+        Put(n);
+        for (std::uint16_t i = 0; i < n; ++i) {
+            const auto& src = st.sources[i];
+            PutString(src.key);
+            Put(src.value);
+            Put(src.expiryRemainingSec);
+            Put(src.catMask);
+            Put(src.flags);
+        }
+        ++g_records;
+        FlushIfNeeded(false);
+    }
+
+    void Actor(std::uint32_t formID, std::uint32_t baseID, std::uint16_t env, float submerge, std::uint8_t activity) {
+        if (!IsRecording()) return;
+        std::scoped_lock l(g_mtx);
+        if (!g_recording.load()) return;
+        Put('A');
+        Put(formID);
+        Put(baseID);
+        Put(env);
+        Put(submerge);
+        Put(activity);
+        ++g_records;
+        FlushIfNeeded(false);
+    }
+
+    namespace {
+        void PutFormID(char tag, std::uint32_t formID) {
+            if (!IsRecording()) return;
+            std::scoped_lock l(g_mtx);
+            if (!g_recording.load()) return;
+            Put(tag);
+            Put(formID);
+            ++g_records;
+            FlushIfNeeded(false);
+        }
+    }
+
+    void GeomChanged(std::uint32_t formID) { PutFormID('G', formID); }
+    void Deselect(std::uint32_t formID) { PutFormID('D', formID); }
+
+    void External(ExtOp op, std::uint32_t formID, std::string_view key, float value, float durationSec,
+                  std::uint32_t catMask, std::uint32_t flags, const float* ov7) {
+        if (!IsRecording()) return;
+        std::scoped_lock l(g_mtx);
+        if (!g_recording.load()) return;
+        Put('X');
+        Put(op);
+        Put(formID);
+        Put(value);
+        Put(durationSec);
+        Put(catMask);
+        Put(flags);
+        for (int i = 0; i < 7; ++i) Put(ov7 ? ov7[i] : -1.f);
+        PutString(key);
+        ++g_records;
+        FlushIfNeeded(false);
+    }
+
+    Reader::Reader(std::istream& is) : _is(is) {
+        char magic[sizeof(kMagic)]{};
+        if (!_is.read(magic, sizeof(magic)) || !std::equal(std::begin(magic), std::end(magic), std::begin(kMagic))) {
+            return;
+        }
+        _valid = Get(_is, _version) && _version <= kVersion;
+    }
+
+    bool Reader::Next(Record& out) {
+        if (!_valid) return false;
+        if (!Get(_is, out.tag)) return false;
+
+        const bool v2 = _version >= 2;
+        switch (out.tag) {
+            case 'C':
+                if (v2 && GetConfig(_is, out.config)) return true;
+                break;
+            case 'L':
+                if (v2 && GetLists(_is, out.lists)) return true;
+                break;
+            case 'T':
+                out.tick.stepDt = 0.f;
+                return Get(_is, out.tick.dt) && Get(_is, out.tick.gameSecDelta) && (!v2 || Get(_is, out.tick.stepDt));
+            case 'S':
+                if (v2 && GetState(_is, out.state)) return true;
+                break;
+            case 'A':
+                out.actor.baseID = 0;
+                return Get(_is, out.actor.formID) && (!v2 || Get(_is, out.actor.baseID)) && Get(_is, out.actor.env) &&
+                       Get(_is, out.actor.submerge) && Get(_is, out.actor.activity);
+            case 'G':
+            case 'D':
+                if (v2 && Get(_is, out.formID)) return true;
+                break;
+            case 'X': {
+                auto& e = out.ext;
+                if (!(Get(_is, e.op) && Get(_is, e.formID) && Get(_is, e.value) && Get(_is, e.durationSec) &&
+                      Get(_is, e.catMask) && Get(_is, e.flags))) {
+                    return false;
+                }
+                for (float& v : e.ov) {
+                    if (!Get(_is, v)) return false;
+                }
+                return GetString<std::uint16_t>(_is, e.key);
+            }
+            default:
+                break;
+        }
+        _valid = false;
+        return false;
+    }
+}
@@ -0,0 +1,204 @@
+#include "utils/Profiler.h"
+
+namespace SWE::Prof {
+
+    namespace {
+        constexpr std::size_t kPhaseCount = static_cast<std::size_t>(Phase::kCount);
+
+        constexpr const char* kPhaseNames[kPhaseCount] = {
+            "Tick",      "AllowList",      "UpdateActor",   "ProbeWater", "ProbeRoof",
+            "ProbeHeat", "ProbeWaterfall", "WetByCategory", "StampProbe", "ApplyMaterials"};
+
+        constexpr const char* kCounterNames[kCounterCount] = {"rays", "refs", "geometries"};
+    }
+
+    const char* PhaseName(Phase phase) noexcept {
+        const auto i = static_cast<std::size_t>(phase);
+        return (i < kPhaseCount) ? kPhaseNames[i] : "?";
+    }
+
+    void WriteChromeTrace(std::ostream& os, std::span<const TraceEvent> events, std::uint64_t dropped) {
+        char buf[96];
+        auto us = [&](std::uint64_t ns) {
+            std::snprintf(buf, sizeof(buf), "%llu.%03llu", static_cast<unsigned long long>(ns / 1000),
+                          static_cast<unsigned long long>(ns % 1000));
+            return std::string_view{buf};
+        };
+
+        os << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped\":" << dropped << "},\"traceEvents\":[";
+        bool first = true;
+        for (const auto& e : events) {
+            os << (first ? "\n" : ",\n");
+            first = false;
+
+            os << "{\"name\":\"" << PhaseName(e.phase) << "\",\"cat\":\"swe\",\"ph\":\"X\",\"pid\":1,\"tid\":1";
+            os << ",\"ts\":" << us(e.startNs);
+            os << ",\"dur\":" << us(e.durNs);
+            os << ",\"args\":{";
+            bool firstArg = true;
+            if (e.formID) {
+                std::snprintf(buf, sizeof(buf), "\"formID\":\"%08X\"", e.formID);
+                os << buf;
+                firstArg = false;
+            }
+            for (std::size_t c = 0; c < kCounterCount; ++c) {
+                if (!e.counts[c]) continue;
+                os << (firstArg ? "" : ",") << '"' << kCounterNames[c] << "\":" << e.counts[c];
+                firstArg = false;
+            }
+            os << "}}";
+        }
+        os << "\n]}\n";
+    }
+}
+
+#if SWE_PROFILE
+
+namespace SWE::Prof {
+
+    namespace {
+        constexpr std::size_t kRingSize = 1024;  // power of two
+
+        // Writers only bump the head and store a sample, so recording never blocks or allocates.
+        struct PhaseRing {
+            std::atomic<std::uint64_t> head{0};
+            std::atomic<std::uint64_t> maxNs{0};
+            std::array<std::atomic<std::uint32_t>, kRingSize> samples{};  // ns, saturated
+            std::uint64_t dumpedHead{0};
+        };
+
+        PhaseRing g_rings[kPhaseCount];
+        std::atomic<std::int64_t> g_lastDump{0};
+
+        thread_local Scope* t_current = nullptr;
+
+        // Only touched on the game thread, the flag lets the scopes skip the capture cheaply.
+        std::atomic<bool> g_capturing{false};
+        std::vector<TraceEvent> g_events;
+        std::size_t g_eventCount{0};
+        std::uint64_t g_dropped{0};
+        std::chrono::steady_clock::time_point g_captureStart{};
+
+        float Percentile(const std::vector<std::uint32_t>& sorted, float p) {
+            const auto i = static_cast<std::size_t>(p * static_cast<float>(sorted.size() - 1) + 0.5f);
+            return static_cast<float>(sorted[std::min(i, sorted.size() - 1)]) / 1000.0f;
+        }
+
+        std::uint64_t ToNs(std::chrono::steady_clock::duration d) {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+        }
+    }
+
+    Scope::Scope(Phase phase, std::uint32_t formID) noexcept
+        : _phase(phase), _formID(formID), _parent(t_current), _t0(std::chrono::steady_clock::now()) {
+        if (!_formID && _parent) _formID = _parent->_formID;
+        t_current = this;
+    }
+
+    Scope::~Scope() {
+        const auto t1 = std::chrono::steady_clock::now();
+        t_current = _parent;
+        Record(_phase, ToNs(t1 - _t0));
+
+        if (_parent) {
+            for (std::size_t c = 0; c < kCounterCount; ++c) _parent->_counts[c] += _counts[c];
+        }
+
+        if (g_capturing.load(std::memory_order_relaxed) && _t0 >= g_captureStart) {
+            if (g_eventCount < g_events.size()) {
+                auto& e = g_events[g_eventCount++];
+                e.startNs = ToNs(_t0 - g_captureStart);
+                e.durNs = ToNs(t1 - _t0);
+                e.formID = _formID;
+                e.phase = _phase;
+                std::copy(std::begin(_counts), std::end(_counts), e.counts);
+            } else {
+                ++g_dropped;
+            }
+        }
+    }
+
+    void AddCount(Counter counter, std::uint32_t n) noexcept {
+        if (t_current) t_current->_counts[static_cast<std::size_t>(counter)] += n;
+    }
+
+    bool IsCapturing() noexcept { return g_capturing.load(std::memory_order_relaxed); }
+
+    void StartCapture(std::size_t maxEvents) {
+        SKSE::GetTaskInterface()->AddTask([maxEvents]() {
+            g_events.assign(std::max<std::size_t>(1, maxEvents), TraceEvent{});
+            g_eventCount = 0;
+            g_dropped = 0;
+            g_captureStart = std::chrono::steady_clock::now();
+            g_capturing.store(true);
+            logger::info("[SWE] trace: capture started ({} events)", g_events.size());
+        });
+    }
+
+    void StopCaptureAndWrite() {
+        SKSE::GetTaskInterface()->AddTask([]() {
+            if (!g_capturing.exchange(false)) return;
+
+            auto path = logger::log_directory();
+            if (!path) {
+                logger::warn("[SWE] trace: no log directory, capture discarded");
+            } else {
+                *path /= "SkyrimWetEffect_trace.json";
+                std::ofstream os(*path, std::ios::binary | std::ios::trunc);
+                if (os) {
+                    WriteChromeTrace(os, std::span<const TraceEvent>(g_events.data(), g_eventCount), g_dropped);
+                    logger::info("[SWE] trace: wrote {} events ({} dropped) to {}", g_eventCount, g_dropped,
+                                 path->string());
+                } else {
+                    logger::warn("[SWE] trace: could not open {}", path->string());
+                }
+            }
+
+            g_events.clear();
+            g_events.shrink_to_fit();
+            g_eventCount = 0;
+        });
+    }
+
+    void Record(Phase phase, std::uint64_t ns) noexcept {
+        auto& r = g_rings[static_cast<std::size_t>(phase)];
+        const std::uint64_t slot = r.head.fetch_add(1, std::memory_order_relaxed) & (kRingSize - 1);
+        r.samples[slot].store(static_cast<std::uint32_t>(std::min<std::uint64_t>(ns, UINT32_MAX)),
+                              std::memory_order_relaxed);
+
+        std::uint64_t prev = r.maxNs.load(std::memory_order_relaxed);
+        while (ns > prev && !r.maxNs.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    void MaybeDump(std::chrono::seconds interval) {
+        const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        auto last = g_lastDump.load(std::memory_order_relaxed);
+        if (last != 0 && std::chrono::steady_clock::duration(now - last) < interval) return;
+        if (!g_lastDump.compare_exchange_strong(last, now)) return;
+        if (last == 0) return;  // first call only arms the timer
+
+        std::vector<std::uint32_t> window;
+        window.reserve(kRingSize);
+
+        logger::info("[SWE] prof: phase            calls     p50us     p95us     p99us     maxus");
+        for (std::size_t i = 0; i < kPhaseCount; ++i) {
+            auto& r = g_rings[i];
+            const std::uint64_t head = r.head.load(std::memory_order_relaxed);
+            const std::uint64_t calls = head - r.dumpedHead;
+            r.dumpedHead = head;
+            if (calls == 0) continue;
+
+            const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(head, kRingSize));
+            window.clear();
+            for (std::size_t s = 0; s < n; ++s) window.push_back(r.samples[s].load(std::memory_order_relaxed));
+            std::sort(window.begin(), window.end());
+
+            const float maxUs = static_cast<float>(r.maxNs.exchange(0, std::memory_order_relaxed)) / 1000.0f;
+            logger::info("[SWE] prof: {:<15} {:>7} {:>9.1f} {:>9.1f} {:>9.1f} {:>9.1f}", kPhaseNames[i], calls,
+                         Percentile(window, 0.50f), Percentile(window, 0.95f), Percentile(window, 0.99f), maxUs);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,127 @@
+#include "utils/SharedTable.h"
+
+namespace SWE::SharedTable {
+
+    namespace {
+        struct Mapping {
+            std::uint8_t* base{nullptr};
+            std::size_t size{0};
+            std::uint32_t capacity{0};
+#ifdef _WIN32
+            HANDLE handle{nullptr};
+#endif
+        };
+        Mapping g_map;
+
+        Shared::Header* Hdr() { return reinterpret_cast<Shared::Header*>(g_map.base); }
+
+        std::uint32_t ProcessID() {
+#ifdef _WIN32
+            return static_cast<std::uint32_t>(GetCurrentProcessId());
+#else
+            return static_cast<std::uint32_t>(getpid());
+#endif
+        }
+    }
+
+    bool Open(std::uint32_t capacity) {
+        if (g_map.base && g_map.capacity == capacity) return true;
+        Close();
+
+        const std::size_t size = sizeof(Shared::Header) + static_cast<std::size_t>(capacity) * sizeof(Shared::Entry);
+#ifdef _WIN32
+        // An existing mapping (a reader kept the previous one open) keeps its size; mapping more than it has fails.
+        HANDLE h = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                      static_cast<DWORD>(static_cast<std::uint64_t>(size) >> 32),
+                                      static_cast<DWORD>(size), Shared::kMappingName);
+        if (!h) return false;
+        void* p = MapViewOfFile(h, FILE_MAP_WRITE, 0, 0, size);
+        if (!p) {
+            CloseHandle(h);
+            return false;
+        }
+        g_map.handle = h;
+#else
+        const int fd = shm_open(Shared::kMappingName, O_CREAT | O_RDWR, 0644);
+        if (fd < 0) return false;
+        void* p = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+            p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            shm_unlink(Shared::kMappingName);
+            return false;
+        }
+#endif
+        g_map.base = static_cast<std::uint8_t*>(p);
+        g_map.size = size;
+        g_map.capacity = capacity;
+
+        // A reused mapping still holds the previous writer's header and rows, and readers may have it open. Keep
+        // counting seq from where it was, resetting it would let a reader that sampled an old even value before the
+        // reinit match it again after and accept a torn copy. A fresh mapping is zero-filled, so this also starts at 0.
+        auto* hdr = static_cast<Shared::Header*>(p);
+        // Already odd if that writer died mid-update
+        const std::uint32_t s = hdr->seq.load(std::memory_order_relaxed) | 1u;
+        hdr->seq.store(s, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        hdr->version = Shared::kVersion;
+        hdr->headerSize = sizeof(Shared::Header);
+        hdr->entryStride = sizeof(Shared::Entry);
+        hdr->capacity = capacity;
+        hdr->writerPid = ProcessID();
+        hdr->count = 0;
+        hdr->publishedMs = Shared::NowMs();
+        hdr->stateVersion = 0;
+        std::memset(hdr->reserved, 0, sizeof(hdr->reserved));
+        hdr->magic = Shared::kMagic;
+        hdr->seq.store(s + 1, std::memory_order_release);
+        return true;
+    }
+
+    void Close() {
+        if (!g_map.base) return;
+        Publish({}, Hdr()->stateVersion);
+#ifdef _WIN32
+        UnmapViewOfFile(g_map.base);
+        CloseHandle(g_map.handle);
+#else
+        munmap(g_map.base, g_map.size);
+        shm_unlink(Shared::kMappingName);
+#endif
+        g_map = {};
+    }
+
+    bool IsOpen() { return g_map.base != nullptr; }
+    std::uint32_t Capacity() { return g_map.capacity; }
+
+    void Publish(std::span<const Shared::Entry> rows, std::uint64_t stateVersion) {
+        Shared::Header* h = Hdr();
+        if (!h) return;
+        const std::size_t n = std::min<std::size_t>(rows.size(), g_map.capacity);
+
+        const std::uint32_t s = h->seq.load(std::memory_order_relaxed);
+        h->seq.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        if (n) std::memcpy(g_map.base + sizeof(Shared::Header), rows.data(), n * sizeof(Shared::Entry));
+        h->count = static_cast<std::uint32_t>(n);
+        h->publishedMs = Shared::NowMs();
+        h->stateVersion = stateVersion;
+
+        h->seq.store(s + 2, std::memory_order_release);
+    }
+
+    void Trim(std::vector<Shared::Entry>& rows, std::uint32_t capacity) {
+        if (rows.size() > capacity) {
+            // the player is seen every tick, so it always makes the cut
+            const auto byRecent = [](const Shared::Entry& a, const Shared::Entry& b) {
+                return a.lastSeenMs > b.lastSeenMs;
+            };
+            std::nth_element(rows.begin(), rows.begin() + capacity, rows.end(), byRecent);
+            rows.resize(capacity);
+        }
+        std::ranges::sort(rows, {}, &Shared::Entry::formID);
+    }
+}
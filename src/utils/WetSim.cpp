@@ -0,0 +1,39 @@
+#include "utils/WetSim.h"
+
+namespace SWE::Sim {
+
+    // While s - rate * step stays above floor, s moves linearly by add - rate * step per step; otherwise it lands on
+    // the fixed point min(1, floor + add). Drying (delta < 0) therefore ends on the fixed point, soaking on 1.
+    float AdvanceCat(float s, float span, float step, float rate, float floor, float add) {
+        auto one = [&](float x, float d) { return Clamp01(std::max(Clamp01(x - rate * d), floor) + add); };
+
+        const float n = span / step;
+        if (n <= 1.f) return one(s, span);
+
+        const float delta = add - rate * step;
+        if (delta >= 0.f) return std::min(1.f, one(s, step) + (n - 1.f) * delta);
+        return std::max(std::min(1.f, std::max(floor, 0.f) + add), s + n * delta);
+    }
+
+    Policy ResolvePolicy(const Settings::ActorListsSnapshot& lists, std::uint32_t refID, std::uint32_t baseID) {
+        Policy p;
+        auto matches = [&](const Settings::FormSpec& fs) { return fs.id && (fs.id == refID || fs.id == baseID); };
+
+        p.listed = lists.enabledIDs.contains(refID) || (baseID && lists.enabledIDs.contains(baseID));
+        for (const auto& fs : lists.tracked) {
+            if (matches(fs)) {
+                p.autoWet = fs.autoWet;
+                break;
+            }
+        }
+        for (const auto& fs : lists.overrides) {
+            if (fs.enabled && matches(fs)) {
+                p.hasOverride = true;
+                p.forcedWet = Clamp01(fs.value);
+                p.forcedMask = (fs.mask & kCatMask);
+                break;
+            }
+        }
+        return p;
+    }
+}
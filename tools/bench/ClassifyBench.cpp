@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include "corpus/Corpus.h"
+#include "corpus/Reference.h"
+#include "utils/Classify.h"
+
+// The material, PBR, heat-source and furniture classifiers over the checked-in corpus, each next to the
+// implementation it replaced (corpus/Reference.h). One iteration is one pass over the whole corpus.
+namespace {
+    using namespace SWE;
+
+    struct Data {
+        Data() {
+            nodes = Corpus::Load("nodes.txt");
+            textures = Corpus::Load("textures.txt");
+            forms = Corpus::Load("forms.txt");
+            geoms = Corpus::GeomCases(nodes, textures);
+            sets = Corpus::TextureSets(textures);
+            for (const auto& c : geoms) names.emplace_back(c.names.begin(), c.names.end());
+            for (const auto* list : {&nodes, &forms})
+                for (const auto& n : *list) refNames.push_back(n.c_str());
+        }
+
+        std::vector<std::string> nodes, textures, forms;
+        std::vector<Corpus::GeomCase> geoms;
+        std::vector<std::vector<std::string_view>> names;  // per geometry, what WetController passes in
+        std::vector<std::vector<const char*>> sets;
+        std::vector<const char*> refNames;  // node names and form names/editor IDs
+    };
+
+    const Data& Get() {
+        static const Data d;
+        return d;
+    }
+
+    void BM_ClassifyGeom(benchmark::State& state) {
+        const Data& d = Get();
+        for (auto _ : state) {
+            for (std::size_t i = 0; i < d.geoms.size(); ++i) {
+                const Corpus::GeomCase& c = d.geoms[i];
+                Classify::Geom g;
+                g.faceGen = c.faceGen;
+                g.hairTint = c.hairTint;
+                g.slots = c.slots;
+                g.diffuse = c.diffuse;
+                g.normal = c.normal;
+                g.names = d.names[i];
+                benchmark::DoNotOptimize(Classify::ClassifyGeom(g));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(d.geoms.size()));
+    }
+
+    void BM_ClassifyGeomReference(benchmark::State& state) {
+        const Data& d = Get();
+        for (auto _ : state) {
+            for (const auto& c : d.geoms) benchmark::DoNotOptimize(Reference::ClassifyGeom(c));
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(d.geoms.size()));
+    }
+
+    void BM_MaterialLooksPBR(benchmark::State& state) {
+        const Data& d = Get();
+        for (auto _ : state) {
+            for (const auto& set : d.sets) benchmark::DoNotOptimize(Classify::TexturesLookPBR(set));
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(d.sets.size()));
+    }
+
+    void BM_MaterialLooksPBRReference(benchmark::State& state) {
+        const Data& d = Get();
+        for (auto _ : state) {
+            for (const auto& set : d.sets) benchmark::DoNotOptimize(Reference::MaterialLooksPBR(set));
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(d.sets.size()));
+    }
+
+    void BM_RefNames(benchmark::State& state) {
+        const Data& d = Get();
+        for (auto _ : state) {
+            for (const char* n : d.refNames) {
+                benchmark::DoNotOptimize(Classify::HeatSourceName(n));
+                benchmark::DoNotOptimize(Classify::WorkFurnitureEditorID(n));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(d.refNames.size()));
+    }
+
+    void BM_RefNamesReference(benchmark::State& state) {
+        const Data& d = Get();
+        for (auto _ : state) {
+            for (const char* n : d.refNames) {
+                benchmark::DoNotOptimize(Reference::LooksLikeHeatSourceName(n));
+                benchmark::DoNotOptimize(Reference::LooksLikeWorkFurniture(n));
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(d.refNames.size()));
+    }
+
+    BENCHMARK(BM_ClassifyGeom);
+    BENCHMARK(BM_ClassifyGeomReference);
+    BENCHMARK(BM_MaterialLooksPBR);
+    BENCHMARK(BM_MaterialLooksPBRReference);
+    BENCHMARK(BM_RefNames);
+    BENCHMARK(BM_RefNamesReference);
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,241 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "utils/CoSave.h"
+
+// The co-save record against a mock of SKSE::SerializationInterface: v6 (one encoded buffer, one write) next to the
+// v5 layout it replaced (every field its own WriteRecordData / ReadRecordData).
+namespace {
+    using namespace SWE;
+
+    // Only the three calls the record uses. Virtual and out of line like the SKSE exports, so every call is paid for.
+    class SerializationInterface {
+    public:
+        virtual ~SerializationInterface() = default;
+        virtual bool WriteRecordData(const void* buf, std::uint32_t length) = 0;
+        virtual std::uint32_t ReadRecordData(void* buf, std::uint32_t length) = 0;
+        virtual bool ResolveFormID(std::uint32_t oldID, std::uint32_t& newID) = 0;
+    };
+
+    class MockSerialization final : public SerializationInterface {
+    public:
+        [[gnu::noinline]] bool WriteRecordData(const void* buf, std::uint32_t length) override {
+            const auto* p = static_cast<const std::uint8_t*>(buf);
+            data.insert(data.end(), p, p + length);
+            ++writes;
+            return true;
+        }
+        [[gnu::noinline]] std::uint32_t ReadRecordData(void* buf, std::uint32_t length) override {
+            length = static_cast<std::uint32_t>(std::min<std::size_t>(length, data.size() - pos));
+            std::memcpy(buf, data.data() + pos, length);
+            pos += length;
+            ++reads;
+            return length;
+        }
+        [[gnu::noinline]] bool ResolveFormID(std::uint32_t oldID, std::uint32_t& newID) override {
+            // a load order that moved one plugin slot; FF (runtime) forms do not survive
+            if ((oldID >> 24) == 0xFF) return false;
+            newID = ((oldID >> 24) == 0x05) ? (oldID & 0x00FFFFFF) | 0x06000000 : oldID;
+            return true;
+        }
+
+        void Rewind() {
+            pos = 0;
+            reads = 0;
+        }
+        void Reset() {
+            data.clear();
+            writes = 0;
+            Rewind();
+        }
+
+        std::vector<std::uint8_t> data;
+        std::size_t pos{0};
+        std::size_t writes{0};
+        std::size_t reads{0};
+    };
+
+    // n actors as a save sees them: most dry or nearly so, some wet from a few shared mod keys, a few with overrides.
+    CoSave::Image MakeImage(std::size_t n) {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+        CoSave::Image img;
+        const char* mods[]{"SWE.Rain", "SWE.Swim", "SWE.Sweat", "OBody.Oil", "SexLab.Fluid", "Frostfall.Exposure",
+                           "Sunhelm.Bath", "Dirt.Bathing", "Alchemy.Potion", "Spell.WaterWalk"};
+        for (const char* m : mods) img.keys.emplace_back(m);
+
+        for (std::size_t i = 0; i < n; ++i) {
+            CoSave::Actor& a = img.actors.emplace_back();
+            const auto id = static_cast<std::uint32_t>(i);
+            a.formID = (i % 7 == 0) ? 0xFF000800u + id : ((id % 6) << 24) | (0x1000u + id);
+            a.wetness = unit(rng);
+            a.lastAppliedWet = a.wetness;
+            a.firstSource = static_cast<std::uint32_t>(img.sources.size());
+            a.sourceCount = static_cast<std::uint32_t>(rng() % 4);
+            for (std::uint32_t s = 0; s < a.sourceCount; ++s) {
+                CoSave::Source& src = img.sources.emplace_back();
+                src.key = static_cast<std::uint32_t>(rng() % std::size(mods));
+                src.value = unit(rng);
+                src.remainSec = (rng() % 3 == 0) ? -1.f : 600.f * unit(rng);
+                src.catMask = static_cast<std::uint8_t>(1 + rng() % 15);
+                if (rng() % 5 == 0) src.ov[0] = src.ov[1] = 0.8f;
+            }
+        }
+        return img;
+    }
+
+    // The v5 record as WetController::Serialize wrote it before v6.
+    void SaveV5(SerializationInterface* intfc, const CoSave::Image& img) {
+        const std::uint32_t magic = CoSave::kMagic;
+        intfc->WriteRecordData(&magic, sizeof(magic));
+        const auto count = static_cast<std::uint32_t>(img.actors.size());
+        intfc->WriteRecordData(&count, sizeof(count));
+        for (const CoSave::Actor& a : img.actors) {
+            intfc->WriteRecordData(&a.formID, sizeof(a.formID));
+            intfc->WriteRecordData(&a.wetness, sizeof(a.wetness));
+            intfc->WriteRecordData(&a.lastAppliedWet, sizeof(a.lastAppliedWet));
+            const auto n = static_cast<std::uint16_t>(a.sourceCount);
+            intfc->WriteRecordData(&n, sizeof(n));
+            for (std::uint32_t i = 0; i < a.sourceCount; ++i) {
+                const CoSave::Source& s = img.sources[a.firstSource + i];
+                const std::string& key = img.keys[s.key];
+                const auto klen = static_cast<std::uint16_t>(key.size());
+                intfc->WriteRecordData(&klen, sizeof(klen));
+                if (klen) intfc->WriteRecordData(key.data(), klen);
+                intfc->WriteRecordData(&s.value, sizeof(s.value));
+                intfc->WriteRecordData(&s.remainSec, sizeof(s.remainSec));
+                intfc->WriteRecordData(&s.catMask, sizeof(s.catMask));
+                intfc->WriteRecordData(&s.flags, sizeof(s.flags));
+                for (const float ov : s.ov) intfc->WriteRecordData(&ov, sizeof(ov));
+            }
+        }
+    }
+
+    // The v5 branch of WetController::Deserialize, into the same Image the v6 path produces.
+    bool LoadV5(SerializationInterface* intfc, CoSave::Image& img) {
+        auto read = [&](void* dst, std::uint32_t sz) { return intfc->ReadRecordData(dst, sz) == sz; };
+        std::uint32_t magic = 0, count = 0;
+        if (!read(&magic, sizeof(magic)) || magic != CoSave::kMagic || !read(&count, sizeof(count))) return false;
+
+        std::unordered_map<std::string, std::uint32_t> keyIndex;
+        for (std::uint32_t i = 0; i < count; ++i) {
+            std::uint32_t fid = 0;
+            float wet = 0.f, last = -1.f;
+            std::uint16_t nsrc = 0;
+            if (!read(&fid, sizeof(fid)) || !read(&wet, sizeof(wet)) || !read(&last, sizeof(last)) ||
+                !read(&nsrc, sizeof(nsrc)))
+                return false;
+            const bool keep = intfc->ResolveFormID(fid, fid);
+
+            CoSave::Actor a{fid, wet, last, static_cast<std::uint32_t>(img.sources.size()), 0};
+            for (std::uint16_t s = 0; s < nsrc; ++s) {
+                std::uint16_t klen = 0;
+                if (!read(&klen, sizeof(klen))) return false;
+                std::string key(klen, '\0');
+                if (klen && !read(key.data(), klen)) return false;
+
+                CoSave::Source src{};
+                if (!read(&src.value, sizeof(src.value)) || !read(&src.remainSec, sizeof(src.remainSec)) ||
+                    !read(&src.catMask, sizeof(src.catMask)) || !read(&src.flags, sizeof(src.flags)) ||
+                    !read(src.ov, sizeof(src.ov)))
+                    return false;
+                if (!keep) continue;
+                auto [it, inserted] = keyIndex.try_emplace(std::move(key), static_cast<std::uint32_t>(img.keys.size()));
+                if (inserted) img.keys.push_back(it->first);
+                src.key = it->second;
+                img.sources.push_back(src);
+                ++a.sourceCount;
+            }
+            if (keep) img.actors.push_back(a);
+        }
+        return true;
+    }
+
+    // The v6 halves of WetController::Serialize / DeserializeV6, without the live-state gathering and Compact.
+    void SaveV6(SerializationInterface* intfc, CoSave::Image& img, std::vector<std::uint8_t>& buf) {
+        buf.clear();
+        CoSave::Encode(img, buf);
+        intfc->WriteRecordData(buf.data(), static_cast<std::uint32_t>(buf.size()));
+    }
+
+    bool LoadV6(SerializationInterface* intfc, std::uint32_t length, CoSave::Image& img) {
+        std::vector<std::uint8_t> buf(length);
+        if (length && intfc->ReadRecordData(buf.data(), length) != length) return false;
+        if (!CoSave::Decode(buf, img)) return false;
+        std::size_t kept = 0;
+        for (auto& a : img.actors) {
+            if (intfc->ResolveFormID(a.formID, a.formID)) img.actors[kept++] = a;
+        }
+        img.actors.resize(kept);
+        return true;
+    }
+
+    void Report(benchmark::State& state, const MockSerialization& mock, std::size_t calls) {
+        state.counters["bytes"] = static_cast<double>(mock.data.size());
+        state.counters["calls"] = static_cast<double>(calls);
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(mock.data.size()));
+    }
+
+    void BM_SaveV5(benchmark::State& state) {
+        const CoSave::Image img = MakeImage(static_cast<std::size_t>(state.range(0)));
+        MockSerialization mock;
+        for (auto _ : state) {
+            mock.Reset();
+            SaveV5(&mock, img);
+            benchmark::DoNotOptimize(mock.data.data());
+        }
+        Report(state, mock, mock.writes);
+    }
+
+    void BM_SaveV6(benchmark::State& state) {
+        CoSave::Image img = MakeImage(static_cast<std::size_t>(state.range(0)));
+        MockSerialization mock;
+        std::vector<std::uint8_t> buf;
+        for (auto _ : state) {
+            mock.Reset();
+            SaveV6(&mock, img, buf);
+            benchmark::DoNotOptimize(mock.data.data());
+        }
+        Report(state, mock, mock.writes);
+    }
+
+    void BM_LoadV5(benchmark::State& state) {
+        MockSerialization mock;
+        SaveV5(&mock, MakeImage(static_cast<std::size_t>(state.range(0))));
+        for (auto _ : state) {
+            mock.Rewind();
+            CoSave::Image img;
+            if (!LoadV5(&mock, img)) state.SkipWithError("v5 record did not load");
+            benchmark::DoNotOptimize(img.actors.data());
+        }
+        Report(state, mock, mock.reads);
+    }
+
+    void BM_LoadV6(benchmark::State& state) {
+        MockSerialization mock;
+        CoSave::Image src = MakeImage(static_cast<std::size_t>(state.range(0)));
+        std::vector<std::uint8_t> buf;
+        SaveV6(&mock, src, buf);
+        const auto length = static_cast<std::uint32_t>(mock.data.size());
+        for (auto _ : state) {
+            mock.Rewind();
+            CoSave::Image img;
+            if (!LoadV6(&mock, length, img)) state.SkipWithError("v6 record did not load");
+            benchmark::DoNotOptimize(img.actors.data());
+        }
+        Report(state, mock, mock.reads);
+    }
+
+    // a handful of NPCs, a busy cell, a long playthrough's worth of remembered actors
+#define SWE_COSAVE_SIZES ->Arg(50)->Arg(500)->Arg(5000)
+    BENCHMARK(BM_SaveV5) SWE_COSAVE_SIZES;
+    BENCHMARK(BM_SaveV6) SWE_COSAVE_SIZES;
+    BENCHMARK(BM_LoadV5) SWE_COSAVE_SIZES;
+    BENCHMARK(BM_LoadV6) SWE_COSAVE_SIZES;
+#undef SWE_COSAVE_SIZES
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "Settings.h"
+
+// The opt-in allow-list check the tick runs for every candidate NPC: two lookups in ActorListsSnapshot::enabledIDs
+// next to the path it replaced, which on a miss lowercased the base's plugin name and scanned both lists for an
+// entry from that plugin with the same local ID. One iteration checks every candidate once.
+namespace {
+    // What the old check read from the game for one actor
+    struct Candidate {
+        std::uint32_t refID{0};
+        std::uint32_t baseID{0};
+        const char* plugin{""};  // TESFile::GetFilename() of the base
+    };
+
+    constexpr const char* kPlugins[]{"Skyrim.esm",    "Update.esm",    "Dawnguard.esm", "HearthFires.esm",
+                                     "Dragonborn.esm", "Immersive.esp", "Followers.esp", "Bandits.esl",
+                                     "Guards.esp",     "Inigo.esp",     "Lucien.esp",    "Vilja.esp"};
+
+    // Load order index of each plugin; the .esl ones are light and live under FE
+    std::uint32_t LoadOrderID(std::size_t plugin, std::uint32_t local) {
+        if (std::string_view(kPlugins[plugin]).ends_with(".esl"))
+            return 0xFE000000u | (static_cast<std::uint32_t>(plugin) << 12) | (local & 0xFFFu);
+        return (static_cast<std::uint32_t>(plugin) << 24) | (local & 0x00FFFFFFu);
+    }
+
+    struct Data {
+        explicit Data(std::size_t entries) {
+            std::mt19937 rng(37);
+            // half tracked, half overrides, as saved: the plugin and the FormID it had when the entry was added
+            for (std::size_t i = 0; i < entries; ++i) {
+                const std::size_t plugin = rng() % std::size(kPlugins);
+                Settings::FormSpec fs;
+                fs.plugin = kPlugins[plugin];
+                fs.id = LoadOrderID(plugin, 0x800u + static_cast<std::uint32_t>(i));
+                fs.enabled = (i % 10) != 0;
+                (i % 2 ? lists.tracked : lists.overrides).push_back(fs);
+                if (fs.enabled) enabled.push_back(fs.id);
+            }
+            // what PublishActorLists builds, the rebase is a no-op for a load order that has not moved
+            for (const auto* list : {&lists.tracked, &lists.overrides})
+                for (const auto& fs : *list)
+                    if (fs.enabled && fs.id) lists.enabledIDs.insert(fs.id);
+
+            // the NPCs around the player in opt-in mode: a few listed bases, the rest are not on either list
+            for (std::uint32_t i = 0; i < 200; ++i) {
+                const std::size_t plugin = rng() % std::size(kPlugins);
+                Candidate& c = candidates.emplace_back();
+                c.refID = 0xFF000000u | (0x1000u + i);
+                c.baseID = (i % 20 == 0) ? enabled[rng() % enabled.size()] : LoadOrderID(plugin, 0x40000u + i);
+                c.plugin = kPlugins[plugin];
+            }
+        }
+
+        Settings::ActorListsSnapshot lists;
+        std::vector<std::uint32_t> enabled;
+        std::vector<Candidate> candidates;
+    };
+
+    const Data& Get(std::size_t entries) {
+        static std::unordered_map<std::size_t, std::unique_ptr<Data>> cache;
+        auto& d = cache[entries];
+        if (!d) d = std::make_unique<Data>(entries);
+        return *d;
+    }
+
+    bool iequals(std::string_view a, std::string_view b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+                   return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+               });
+    }
+
+    // isAllowed as the tick had it before the lists were resolved into enabledIDs
+    bool AllowedLinear(const Settings::ActorListsSnapshot& lists, const Candidate& a) {
+        auto local_id = [](std::uint32_t id) -> std::uint32_t {
+            return ((id >> 24) == 0xFEu) ? (id & 0x00000FFFu) : (id & 0x00FFFFFFu);
+        };
+        auto same_local = [&](std::uint32_t x, std::uint32_t y) -> bool {
+            if (!x || !y) return false;
+            return local_id(x) == local_id(y);
+        };
+
+        if (lists.enabledIDs.count(a.refID) || lists.enabledIDs.count(a.baseID)) return true;
+
+        // ESL safe check
+        const std::string plugin = a.plugin;
+        if (!plugin.empty()) {
+            auto matches = [&](const Settings::FormSpec& fs) {
+                if (!fs.enabled || !fs.id || fs.plugin.empty()) return false;
+                if (!iequals(fs.plugin, plugin)) return false;
+                return same_local(fs.id, a.baseID) || same_local(fs.id, a.refID);
+            };
+            if (std::any_of(lists.tracked.begin(), lists.tracked.end(), matches)) return true;
+            if (std::any_of(lists.overrides.begin(), lists.overrides.end(), matches)) return true;
+        }
+        return false;
+    }
+
+    bool AllowedHashed(const Settings::ActorListsSnapshot& lists, const Candidate& a) {
+        return lists.enabledIDs.contains(a.refID) || (a.baseID && lists.enabledIDs.contains(a.baseID));
+    }
+
+    template <bool (*Allowed)(const Settings::ActorListsSnapshot&, const Candidate&)>
+    void BM_OptInCheck(benchmark::State& state) {
+        const Data& d = Get(static_cast<std::size_t>(state.range(0)));
+        std::size_t allowed = 0;
+        for (auto _ : state) {
+            allowed = 0;
+            for (const Candidate& c : d.candidates) allowed += Allowed(d.lists, c);
+            benchmark::DoNotOptimize(allowed);
+        }
+        state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(d.candidates.size()));
+        state.counters["allowed"] = static_cast<double>(allowed);
+    }
+
+    // 500 entries is a heavily curated follower/NPC list; both paths must let the same actors through
+#define SWE_LIST_SIZES ->Arg(50)->Arg(500)
+    BENCHMARK(BM_OptInCheck<AllowedLinear>)->Name("BM_OptInLinear") SWE_LIST_SIZES;
+    BENCHMARK(BM_OptInCheck<AllowedHashed>)->Name("BM_OptInHashed") SWE_LIST_SIZES;
+#undef SWE_LIST_SIZES
+}
+
+BENCHMARK_MAIN();
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// The checked-in classifier corpus (nodes.txt, textures.txt, forms.txt next to this header) and the cases the tests
+// and the benchmark build from it. SWE_CORPUS_DIR is set by tools/CMakeLists.txt.
+namespace SWE::Corpus {
+
+    inline std::vector<std::string> Load(const std::string& file) {
+        std::ifstream in(std::string(SWE_CORPUS_DIR) + "/" + file, std::ios::binary);
+        if (!in) throw std::runtime_error("corpus file missing: " + file);
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(in, line);) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty() || line[0] == '#') continue;
+            lines.push_back(std::move(line));
+        }
+        return lines;
+    }
+
+    // One geometry: its material, its partitions' biped slots, its diffuse/normal and its name chain.
+    struct GeomCase {
+        bool faceGen{false};
+        bool hairTint{false};
+        std::vector<std::uint16_t> slots;
+        const char* diffuse{nullptr};  // into the textures corpus, or null for no texture set
+        const char* normal{nullptr};
+        std::vector<std::string> names;  // geometry first, then its parents
+    };
+
+    // Every node name as a geometry, under every partition layout that reaches a different branch of ClassifyGeom,
+    // with parents, textures and material features picked from the corpus in a fixed pattern.
+    inline std::vector<GeomCase> GeomCases(const std::vector<std::string>& nodes,
+                                           const std::vector<std::string>& textures) {
+        static const std::vector<std::vector<std::uint16_t>> kSlots{
+            {}, {30}, {31}, {32}, {33}, {37}, {34}, {41}, {44}, {52, 32}, {32, 30}, {45, 46, 47}};
+        std::vector<GeomCase> cases;
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            for (std::size_t s = 0; s < kSlots.size(); ++s) {
+                GeomCase& c = cases.emplace_back();
+                const std::size_t k = i * kSlots.size() + s;
+                c.faceGen = k % 29 == 0;
+                c.hairTint = k % 31 == 0;
+                c.slots = kSlots[s];
+                if (k % 5 != 0) {
+                    const std::size_t t = (k * 7) % textures.size();
+                    c.diffuse = textures[t].c_str();
+                    c.normal = (k % 3 == 0) ? nullptr : textures[(t + 1) % textures.size()].c_str();
+                }
+                const std::size_t depth = 1 + k % 8;
+                c.names.push_back(nodes[i]);
+                for (std::size_t d = 1; d < depth; ++d) c.names.push_back(nodes[(i + d * 13 + s) % nodes.size()]);
+            }
+        }
+        return cases;
+    }
+
+    // Six-slot texture sets (diffuse, normal, specular, glow, environment mask, backlight) over the corpus, some
+    // slots empty.
+    inline std::vector<std::vector<const char*>> TextureSets(const std::vector<std::string>& textures) {
+        std::vector<std::vector<const char*>> sets;
+        for (std::size_t i = 0; i < textures.size(); ++i) {
+            for (std::size_t used = 1; used <= 6; used += 2) {
+                std::vector<const char*>& set = sets.emplace_back(6, nullptr);
+                for (std::size_t j = 0; j < used; ++j)
+                    set[(i + j) % 6] = (j == 1 && i % 4 == 0) ? "" : textures[(i + j * 11) % textures.size()].c_str();
+            }
+        }
+        return sets;
+    }
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Corpus.h"
+
+// The classifiers as WetController had them before they moved to utils/Classify, with the scene graph and texture
+// set replaced by the corpus cases. The tests hold the current ones to these results; the benchmark times both.
+namespace SWE::Reference {
+
+    enum class MatCat { SkinFace, Hair, ArmorClothing, Weapon, Other };
+
+    inline bool NameHas(const std::string& name, std::string_view s) {
+        std::string n = name;
+        std::transform(n.begin(), n.end(), n.begin(), [](unsigned char c) { return std::tolower(c); });
+        std::string t(s);
+        std::transform(t.begin(), t.end(), t.begin(), [](unsigned char c) { return std::tolower(c); });
+        return n.find(t) != std::string::npos;
+    }
+
+    inline std::string lc_norm_path(const char* p) {
+        if (!p || !p[0]) return {};
+        std::string s(p);
+        std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+        std::replace(s.begin(), s.end(), '\\', '/');
+        s.erase(std::unique(s.begin(), s.end(), [](char a, char b) { return a == '/' && b == '/'; }), s.end());
+        return s;
+    }
+
+    inline bool LooksLikeHeatSourceName(const char* nm) {
+        auto lc = [](std::string s) {
+            std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+            return s;
+        };
+        std::string n = lc(nm);
+        if (n.find("campfire") != std::string::npos || n.find("fireplace") != std::string::npos ||
+            n.find("brazier") != std::string::npos || n.find("hearth") != std::string::npos ||
+            n.find("embers") != std::string::npos || n.find("forge") != std::string::npos ||
+            n.find("smelter") != std::string::npos)
+            return true;
+
+        if (n.find("fire") != std::string::npos && n.find("torch") == std::string::npos &&
+            n.find("candle") == std::string::npos)
+            return true;
+        return false;
+    }
+
+    inline bool LooksLikeWorkFurniture(const char* ed) {
+        const auto lc = [](std::string s) {
+            std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+            return s;
+        };
+        std::string name = lc(ed ? ed : "");
+        const char* keys[] = {"workbench", "forge",   "smelter", "grindstone", "tanning",
+                              "alchemy",   "enchant", "cooking", "chopping",   "choppingblock",
+                              "sawmill",   "mine",    "mining",  "ore",        "blacksmith"};
+        for (auto* k : keys)
+            if (name.find(k) != std::string::npos) return true;
+        return false;
+    }
+
+    inline bool TexLooksLikeBodySkin(const char* diffuse, const char* normal) {
+        auto has = [&](int idx, std::string_view needle) {
+            const char* p = idx == 0 ? diffuse : normal;
+            if (!p || !p[0]) return false;
+            std::string s(p);
+            std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+            return s.find(needle) != std::string::npos;
+        };
+
+        const bool inActors = has(0, "actors/character") || has(1, "actors/character");
+        const bool skinish = has(0, "body") || has(1, "body") || has(0, "hand") || has(1, "hand") || has(0, "feet") ||
+                             has(1, "feet") || has(0, "skin") || has(1, "skin");
+        const bool armorish = has(0, "armor/") || has(1, "armor/") || has(0, "clothes/") || has(1, "clothes/");
+        return inActors && skinish && !armorish;
+    }
+
+    // names[i] stands in for the node i levels above the geometry
+    inline bool LooksLikeBodySkin(const std::vector<std::string>& names, std::size_t first) {
+        for (std::size_t i = first; i < first + 4 && i < names.size(); ++i) {
+            const std::string& cur = names[i];
+            const bool isSkiny = NameHas(cur, "body") || NameHas(cur, "hands") || NameHas(cur, "hand") ||
+                                 NameHas(cur, "feet") || NameHas(cur, "foot") || NameHas(cur, "skin") ||
+                                 NameHas(cur, "femalebody") || NameHas(cur, "malebody");
+            const bool looksArmor = NameHas(cur, "armor") || NameHas(cur, "cuirass") || NameHas(cur, "gauntlet") ||
+                                    NameHas(cur, "glove") || NameHas(cur, "boot") || NameHas(cur, "shoe") ||
+                                    NameHas(cur, "robe");
+            if (isSkiny && !looksArmor) return true;
+        }
+        return false;
+    }
+
+    inline std::string_view filename_no_ext(std::string_view path) {
+        const size_t slash = path.find_last_of('/');
+        std::string_view file = (slash == std::string::npos) ? path : path.substr(slash + 1);
+        const size_t dot = file.find_last_of('.');
+        return (dot == std::string::npos) ? file : file.substr(0, dot);
+    }
+
+    inline bool has_suffix_token(std::string_view path, std::string_view token) {
+        const std::string_view base = filename_no_ext(path);
+        if (base.size() < token.size()) return false;
+        const size_t pos = base.size() - token.size();
+        if (base.substr(pos) != token) return false;
+        if (pos == 0) return true;
+        const char prev = base[pos - 1];
+        return prev == '_' || prev == '-' || prev == '.';
+    }
+
+    inline bool has_ambiguous_p_suffix(std::string_view path) { return has_suffix_token(path, "p"); }
+
+    inline bool contains_word(std::string_view s, std::string_view w) { return s.find(w) != std::string::npos; }
+
+    inline bool strong_pbr_signal(std::string_view p) {
+        if (contains_word(p, "/pbr/") || contains_word(p, "_pbr") || contains_word(p, "/pbr_")) return true;
+
+        if (has_suffix_token(p, "orm") || has_suffix_token(p, "rma") || has_suffix_token(p, "rmao") ||
+            has_suffix_token(p, "rmaos") || has_suffix_token(p, "rmos") || has_suffix_token(p, "mrao") ||
+            has_suffix_token(p, "maos"))
+            return true;
+
+        if (contains_word(p, "roughness") || contains_word(p, "rough") || contains_word(p, "metalness") ||
+            contains_word(p, "metallic") || contains_word(p, "metal"))
+            return true;
+
+        return false;
+    }
+
+    inline bool MaterialLooksPBR(const std::vector<const char*>& set) {
+        std::string paths[6];
+        for (std::size_t i = 0; i < 6 && i < set.size(); ++i) paths[i] = lc_norm_path(set[i]);
+
+        bool anyStrong = false;
+        bool anyAmbigP = false;
+
+        for (const auto& p : paths) {
+            if (p.empty()) continue;
+            if (strong_pbr_signal(p)) anyStrong = true;
+            if (has_ambiguous_p_suffix(p)) anyAmbigP = true;
+        }
+
+        // _p only textures are ambiguous, could be Parallax Height or could be ORM
+        return anyStrong || (anyAmbigP && anyStrong);
+    }
+
+    inline MatCat ClassifyGeom(const Corpus::GeomCase& g) {
+        if (g.faceGen) return MatCat::SkinFace;
+        if (g.hairTint) return MatCat::Hair;
+
+        for (const std::uint16_t slot : g.slots) {
+            switch (slot) {
+                case 30:
+                    return MatCat::SkinFace;
+                case 31:
+                    return MatCat::Hair;
+                case 41:
+                    return MatCat::Weapon;
+                case 32:
+                case 33:
+                case 37: {
+                    if (TexLooksLikeBodySkin(g.diffuse, g.normal) || LooksLikeBodySkin(g.names, 0))
+                        return MatCat::SkinFace;
+                    return MatCat::ArmorClothing;
+                }
+                case 34:
+                case 35:
+                case 36:
+                case 38:
+                case 39:
+                case 40:
+                    return MatCat::ArmorClothing;
+                default:
+                    break;
+            }
+        }
+
+        for (std::size_t i = 0; i < 4 && i < g.names.size(); ++i) {
+            const std::string& cur = g.names[i];
+            if (NameHas(cur, "hair")) return MatCat::Hair;
+            if (NameHas(cur, "head") || NameHas(cur, "face")) return MatCat::SkinFace;
+            if (LooksLikeBodySkin(g.names, i)) return MatCat::SkinFace;
+            if (NameHas(cur, "weapon") || NameHas(cur, "sword") || NameHas(cur, "bow") || NameHas(cur, "dagger"))
+                return MatCat::Weapon;
+        }
+
+        return MatCat::ArmorClothing;
+    }
+}
@@ -0,0 +1,120 @@
+#include "Replay.h"
+
+namespace SWE::Replay {
+
+    namespace {
+        // v1 recordings have no step length; a 20x timescale is the game's default
+        float DefaultStep(const Settings::Config& cfg) {
+            return static_cast<float>(cfg.tickIntervalMs) / 1000.f * 21.f;
+        }
+    }
+
+    Player::Player() {
+        Settings::DeriveConfig(_cfg);
+        _step = DefaultStep(_cfg);
+    }
+
+    bool Player::Apply(const Rec::Record& r) {
+        const auto start = std::chrono::steady_clock::now();
+        switch (r.tag) {
+            case 'C':
+                _cfg = r.config;
+                _sawConfig = true;
+                return true;
+            case 'L':
+                _lists = r.lists;
+                return true;
+            case 'T':
+                _clock += r.tick.dt;
+                _dt = r.tick.dt;
+                _step = (r.tick.stepDt > 0.f) ? r.tick.stepDt : DefaultStep(_cfg);
+                _ticks.push_back({r.tick.dt, 0, {}});
+                return true;
+            case 'S': {
+                const auto& st = r.state;
+                Actor& wd = _actors[st.formID];
+                wd.wetness = st.wetness;
+                wd.lastAppliedWet = st.lastAppliedWet;
+                std::copy(std::begin(st.lastAppliedCat), std::end(st.lastAppliedCat), wd.lastAppliedCat);
+                std::copy(std::begin(st.simCat), std::end(st.simCat), wd.simCat);
+                wd.simInit = st.simInit;
+                wd.activityLevel = st.activityLevel;
+                wd.simTime = (st.simAge < 0.0) ? -1.0 : _clock - st.simAge;
+                wd.envClass = static_cast<Sim::EnvClass>(st.envClass);
+                wd.extSources.clear();
+                for (const auto& src : st.sources)
+                    wd.extSources[src.key] = {src.value, src.expiryRemainingSec, src.catMask, src.flags};
+                break;
+            }
+            case 'A':
+                Update(r.actor);
+                break;
+            case 'G':
+                if (auto it = _actors.find(r.formID); it != _actors.end())
+                    Sim::CommitApplied(it->second, it->second.lastOut, it->second.lastFinal, true);
+                break;
+            case 'D':
+                // what the tick does to an actor that left the opt-in selection
+                if (auto it = _actors.find(r.formID); it != _actors.end()) {
+                    Actor& wd = it->second;
+                    wd.wetness = 0.f;
+                    wd.lastAppliedWet = 0.f;
+                    std::fill(std::begin(wd.lastAppliedCat), std::end(wd.lastAppliedCat), 0.f);
+                    wd.extSources.clear();
+                }
+                break;
+            case 'X': {
+                const auto& e = r.ext;
+                ++_externals;
+                if (e.op == Rec::ExtOp::Clear) {
+                    if (auto it = _actors.find(e.formID); it != _actors.end()) it->second.extSources.erase(e.key);
+                    break;
+                }
+                // v2 stores the source as the API left it; v1 has the raw arguments, which this only approximates
+                auto& src = _actors[e.formID].extSources[e.key];
+                src.value = Sim::Clamp01(e.value);
+                src.expiryRemainingSec = (e.durationSec > 0.f) ? e.durationSec : -1.f;
+                if (e.catMask & Sim::kCatMask)
+                    src.catMask = static_cast<std::uint8_t>(e.catMask & Sim::kCatMask);
+                else if (src.catMask == 0)
+                    src.catMask = 1;
+                if (e.op != Rec::ExtOp::SetEx || e.flags) src.flags = e.flags;
+                break;
+            }
+            default:
+                return false;
+        }
+        if (!_ticks.empty()) _ticks.back().work += std::chrono::steady_clock::now() - start;
+        return true;
+    }
+
+    void Player::Update(const Rec::ActorRec& rec) {
+        Actor& wd = _actors[rec.formID];
+        Sim::SettleActor(wd, _clock - _dt, _step, _cfg);
+
+        Sim::ActorInput in;
+        in.clock = _clock;
+        in.dt = _dt;
+        in.step = _step;
+        in.allowEnvWet = (rec.env & Rec::kEnvAllowEnv) != 0;
+        in.inWater = (rec.env & Rec::kEnvWater) != 0;
+        in.nearWaterfall = (rec.env & Rec::kEnvWaterfall) != 0;
+        in.exposed = (rec.env & Rec::kEnvExposed) != 0;
+        in.rain = (rec.env & Rec::kEnvRain) != 0;
+        in.snow = (rec.env & Rec::kEnvSnow) != 0;
+        in.nearHeat = (rec.env & Rec::kEnvNearHeat) != 0;
+        in.active = rec.activity != 0;
+        if (rec.env & Rec::kEnvManual) {
+            const Sim::Policy p = Sim::ResolvePolicy(_lists, rec.formID, rec.baseID);
+            in.forced = p.hasOverride;
+            in.forcedWet = p.forcedWet;
+            in.forcedMask = p.forcedMask;
+        }
+
+        const float wFinal = Sim::UpdateActor(wd, in, _cfg, wd.lastOut);
+        wd.wetness = wd.lastFinal = wFinal;
+        Sim::CommitApplied(wd, wd.lastOut, wFinal, false);
+        ++wd.updates;
+        if (!_ticks.empty()) ++_ticks.back().actors;
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "utils/InputRecorder.h"
+#include "utils/WetSim.h"
+
+// Runs a recording (see InputRecorder.h) through the same simulation steps the tick uses, with the settings and
+// actor lists it captured, and times the work of every tick.
+namespace SWE::Replay {
+
+    struct Source {
+        float value{0.f};
+        float expiryRemainingSec{-1.f};
+        std::uint8_t catMask{0};
+        std::uint32_t flags{0};
+    };
+
+    // The simulated part of WetController::WetData.
+    struct Actor {
+        float wetness{0.f};
+        float lastAppliedWet{-1.f};
+        float lastAppliedCat[4]{-1.f, -1.f, -1.f, -1.f};
+        float simCat[4]{};
+        bool simInit{false};
+        float activityLevel{0.f};
+        double simTime{-1.0};
+        Sim::EnvClass envClass{Sim::EnvClass::kDrying};
+        std::unordered_map<std::string, Source> extSources;
+
+        float lastOut[4]{};  // what the last update computed, for a 'G' that follows it
+        float lastFinal{0.f};
+        std::uint32_t updates{0};
+    };
+
+    struct Tick {
+        float dt{0.f};
+        std::uint32_t actors{0};
+        std::chrono::nanoseconds work{0};  // spent on the records of this tick
+    };
+
+    class Player {
+        // captured states carry their age, simTime < 0 means never simulated: start far enough in
+        static constexpr double kClockStart = 1e9;
+
+    public:
+        Player();
+
+        // False for a record the recorder does not write.
+        bool Apply(const Rec::Record& r);
+
+        const std::unordered_map<std::uint32_t, Actor>& Actors() const { return _actors; }
+        const std::vector<Tick>& Ticks() const { return _ticks; }
+        const Settings::Config& Config() const { return _cfg; }
+        const Settings::ActorListsSnapshot& Lists() const { return _lists; }
+        double Clock() const { return _clock - kClockStart; }  // simulated seconds
+        std::uint64_t Externals() const { return _externals; }
+        bool SawConfig() const { return _sawConfig; }
+
+    private:
+        void Update(const Rec::ActorRec& rec);
+
+        Settings::Config _cfg;
+        Settings::ActorListsSnapshot _lists;
+        std::unordered_map<std::uint32_t, Actor> _actors;
+        std::vector<Tick> _ticks;
+        double _clock{kClockStart};
+        float _dt{0.f};
+        float _step{0.f};
+        std::uint64_t _externals{0};
+        bool _sawConfig{false};
+    };
+}
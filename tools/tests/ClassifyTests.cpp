@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <new>
+
+#include "corpus/Corpus.h"
+#include "corpus/Reference.h"
+#include "utils/Classify.h"
+
+// The classifiers in utils/Classify against the implementations they replaced (corpus/Reference.h), over the
+// checked-in corpus, plus a few fixed expectations so the corpus itself stays meaningful.
+
+// Counts heap allocations so the no-allocation promise of Classify.h can be checked. Every replaceable form the
+// test can reach is replaced, so each allocation is freed by its own counterpart.
+namespace {
+    std::size_t g_allocs = 0;
+
+    void* Counted(std::size_t n) {
+        ++g_allocs;
+        if (void* p = std::malloc(n ? n : 1)) return p;
+        throw std::bad_alloc();
+    }
+}
+void* operator new(std::size_t n) { return Counted(n); }
+void* operator new[](std::size_t n) { return Counted(n); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+    using namespace SWE;
+
+    struct ClassifyCorpus : ::testing::Test {
+        static void SetUpTestSuite() {
+            nodes = Corpus::Load("nodes.txt");
+            textures = Corpus::Load("textures.txt");
+            forms = Corpus::Load("forms.txt");
+        }
+        static inline std::vector<std::string> nodes, textures, forms;
+    };
+
+    Classify::MatCat Classified(const Corpus::GeomCase& c, std::span<const std::uint16_t> slots) {
+        std::vector<std::string_view> names(c.names.begin(), c.names.end());
+        Classify::Geom g;
+        g.faceGen = c.faceGen;
+        g.hairTint = c.hairTint;
+        g.slots = slots;
+        g.diffuse = c.diffuse;
+        g.normal = c.normal;
+        g.names = names;
+        return Classify::ClassifyGeom(g);
+    }
+
+    Classify::MatCat Classified(const Corpus::GeomCase& c) { return Classified(c, c.slots); }
+
+    Corpus::GeomCase Case(std::vector<std::string> names, std::vector<std::uint16_t> slots = {},
+                          const char* diffuse = nullptr, const char* normal = nullptr) {
+        Corpus::GeomCase c;
+        c.names = std::move(names);
+        c.slots = std::move(slots);
+        c.diffuse = diffuse;
+        c.normal = normal;
+        return c;
+    }
+}
+
+TEST_F(ClassifyCorpus, CorpusIsLoaded) {
+    EXPECT_GT(nodes.size(), 100u);
+    EXPECT_GT(textures.size(), 50u);
+    EXPECT_GT(forms.size(), 30u);
+}
+
+TEST_F(ClassifyCorpus, GeometryMatchesTheReference) {
+    const auto cases = Corpus::GeomCases(nodes, textures);
+    std::size_t perCat[4]{};
+    for (const auto& c : cases) {
+        const auto want = Reference::ClassifyGeom(c);
+        ASSERT_EQ(static_cast<int>(Classified(c)), static_cast<int>(want)) << c.names[0];
+        ++perCat[static_cast<int>(want)];
+    }
+    // every category is reached, so the comparison is not over one branch only
+    for (const std::size_t n : perCat) EXPECT_GT(n, 20u);
+}
+
+TEST_F(ClassifyCorpus, OnlyTheFirstBodySlotCounts) {
+    // WetController passes just the first partition slot in 30-41
+    for (const auto& c : Corpus::GeomCases(nodes, textures)) {
+        auto it = std::find_if(c.slots.begin(), c.slots.end(), [](std::uint16_t s) { return s >= 30 && s <= 41; });
+        const std::span<const std::uint16_t> first = (it == c.slots.end()) ? std::span<const std::uint16_t>{}
+                                                                           : std::span<const std::uint16_t>(&*it, 1);
+        ASSERT_EQ(static_cast<int>(Classified(c, first)), static_cast<int>(Classified(c))) << c.names[0];
+    }
+}
+
+TEST_F(ClassifyCorpus, BodySkinMatchesTheReference) {
+    for (const auto& n : nodes) EXPECT_EQ(Classify::BodySkinName(n), Reference::LooksLikeBodySkin({n}, 0)) << n;
+    for (const auto& d : textures) {
+        for (const auto& n : textures)
+            ASSERT_EQ(Classify::BodySkinTextures(d.c_str(), n.c_str()),
+                      Reference::TexLooksLikeBodySkin(d.c_str(), n.c_str()))
+                << d << " / " << n;
+        EXPECT_EQ(Classify::BodySkinTextures(d.c_str(), nullptr), Reference::TexLooksLikeBodySkin(d.c_str(), nullptr));
+    }
+}
+
+TEST_F(ClassifyCorpus, PBRMatchesTheReference) {
+    for (const auto& p : textures) {
+        const std::string norm = Reference::lc_norm_path(p.c_str());
+        EXPECT_EQ(Classify::NormPath(p).view(), norm) << p;
+        EXPECT_EQ(Classify::StrongPBRSignal(norm), Reference::strong_pbr_signal(norm)) << p;
+        EXPECT_EQ(Classify::HasAmbiguousPSuffix(norm), Reference::has_ambiguous_p_suffix(norm)) << p;
+    }
+    for (const auto& set : Corpus::TextureSets(textures))
+        ASSERT_EQ(Classify::TexturesLookPBR(set), Reference::MaterialLooksPBR(set)) << set[0];
+}
+
+TEST_F(ClassifyCorpus, NamesMatchTheReference) {
+    for (const auto* list : {&nodes, &forms}) {
+        for (const auto& n : *list) {
+            EXPECT_EQ(Classify::HeatSourceName(n), Reference::LooksLikeHeatSourceName(n.c_str())) << n;
+            EXPECT_EQ(Classify::WorkFurnitureEditorID(n), Reference::LooksLikeWorkFurniture(n.c_str())) << n;
+        }
+    }
+}
+
+TEST(Classify, KnownGeometry) {
+    using M = Classify::MatCat;
+    const char* femaleBody = "textures\\actors\\character\\female\\femalebody_1.dds";
+    EXPECT_EQ(Classified(Case({"FemaleBody_1", "Scene Root"}, {32}, femaleBody)), M::SkinFace);
+    EXPECT_EQ(Classified(Case({"3BA", "Scene Root"}, {32}, "textures/actors/character/female/femalebody_1.dds")),
+              M::SkinFace);
+    EXPECT_EQ(Classified(Case({"IronArmorCuirass"}, {32}, "textures\\armor\\iron\\ironarmor.dds")), M::ArmorClothing);
+    EXPECT_EQ(Classified(Case({"KSHairdo_Wind", "Scene Root"})), M::Hair);
+    EXPECT_EQ(Classified(Case({"Ponytail"}, {31})), M::Hair);
+    EXPECT_EQ(Classified(Case({"SteelSword"})), M::Weapon);
+    EXPECT_EQ(Classified(Case({"CBBE Gloves"}, {33})), M::ArmorClothing);
+    // a parent named like a body wins over a weapon-looking shape
+    EXPECT_EQ(Classified(Case({"SteelSword", "3BA Body"})), M::SkinFace);
+    // substring matching: "Elbow" reads as a bow
+    EXPECT_EQ(Classified(Case({"Elbow"})), M::Weapon);
+}
+
+TEST(Classify, KnownTextureSets) {
+    const std::vector<const char*> pbr{"textures\\pbr\\armor\\iron\\ironarmor.dds", nullptr};
+    const std::vector<const char*> parallax{"textures\\architecture\\whiterun\\wrstone01.dds",
+                                            "textures\\architecture\\whiterun\\wrstone01_p.dds"};
+    EXPECT_TRUE(Classify::TexturesLookPBR(pbr));
+    EXPECT_TRUE(Classify::HasAmbiguousPSuffix(Classify::NormPath(parallax[1]).view()));
+    EXPECT_FALSE(Classify::TexturesLookPBR(parallax));  // _p alone is not enough
+}
+
+TEST(Classify, KnownForms) {
+    EXPECT_TRUE(Classify::HeatSourceName("Campfire"));
+    EXPECT_TRUE(Classify::HeatSourceName("Cooking Fire"));
+    EXPECT_FALSE(Classify::HeatSourceName("Wall Torch"));
+    EXPECT_FALSE(Classify::HeatSourceName("Candlestick"));
+    EXPECT_TRUE(Classify::WorkFurnitureEditorID("CraftingTanningRack"));
+    EXPECT_TRUE(Classify::WorkFurnitureEditorID("WoodChoppingBlock"));
+    EXPECT_FALSE(Classify::WorkFurnitureEditorID("ChairCommonWood"));
+}
+
+TEST(Classify, DoesNotAllocate) {
+    const std::string_view names[]{"NPC Spine2 [Spn2]", "3BA Body", "Scene Root"};
+    const std::uint16_t slot = 32;
+    Classify::Geom g;
+    g.slots = std::span(&slot, 1);
+    g.diffuse = "textures\\actors\\character\\female\\femalebody_1.dds";
+    g.names = names;
+    const char* set[]{"textures\\armor\\iron\\ironarmor.dds", "textures\\armor\\iron\\ironarmor_n.dds",
+                      "textures\\\\armor\\iron\\ironarmor_p.dds"};
+
+    const std::size_t before = g_allocs;
+    const auto cat = Classify::ClassifyGeom(g);
+    const bool pbr = Classify::TexturesLookPBR(set);
+    const bool heat = Classify::HeatSourceName("Campfire");
+    const bool work = Classify::WorkFurnitureEditorID("ChairCommonWood");
+    const std::size_t after = g_allocs;
+    EXPECT_EQ(after, before);
+    EXPECT_EQ(cat, Classify::MatCat::SkinFace);
+    EXPECT_FALSE(pbr);
+    EXPECT_TRUE(heat);
+    EXPECT_FALSE(work);
+
+    // longer than the inline buffer: still right, one allocation
+    std::string longPath(Classify::NormPath::kInline, 'a');
+    longPath += "\\Metal.dds";
+    const std::size_t beforeLong = g_allocs;
+    const bool metal = Classify::StrongPBRSignal(Classify::NormPath(longPath).view());
+    EXPECT_EQ(g_allocs, beforeLong + 1);
+    EXPECT_TRUE(metal);
+}
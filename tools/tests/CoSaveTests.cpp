@@ -0,0 +1,359 @@
+#include <gtest/gtest.h>
+
+#include <map>
+
+#include "utils/CoSave.h"
+
+// The co-save record: Encode/Decode round trips, what Decode refuses, and what Compact keeps under the save limits.
+namespace {
+    using namespace SWE;
+
+    constexpr std::uint32_t kPlayer = 0x14;
+
+    struct ImageBuilder {
+        CoSave::Image img;
+        std::map<std::string, std::uint32_t> keyIndex;
+
+        CoSave::Actor& Actor(std::uint32_t formID, float wetness) {
+            CoSave::Actor& a = img.actors.emplace_back();
+            a.formID = formID;
+            a.wetness = wetness;
+            a.lastAppliedWet = wetness;
+            a.firstSource = static_cast<std::uint32_t>(img.sources.size());
+            return a;
+        }
+
+        // Adds to the actor added last
+        CoSave::Source& Source(const std::string& key, float value, float remainSec = -1.f) {
+            auto [it, inserted] = keyIndex.try_emplace(key, static_cast<std::uint32_t>(img.keys.size()));
+            if (inserted) img.keys.push_back(key);
+            CoSave::Source& s = img.sources.emplace_back();
+            s.key = it->second;
+            s.value = value;
+            s.remainSec = remainSec;
+            ++img.actors.back().sourceCount;
+            return s;
+        }
+    };
+
+    // Rewrites the trailing FNV-1a so a damaged body gets past the checksum and reaches the parser
+    void Reseal(std::vector<std::uint8_t>& buf) {
+        if (buf.size() < sizeof(std::uint32_t)) return;
+        std::uint32_t h = 2166136261u;
+        for (std::size_t i = 0; i + sizeof(h) < buf.size(); ++i) h = (h ^ buf[i]) * 16777619u;
+        std::memcpy(buf.data() + buf.size() - sizeof(h), &h, sizeof(h));
+    }
+
+    std::vector<std::uint8_t> Encoded(CoSave::Image img) {
+        std::vector<std::uint8_t> buf;
+        CoSave::Encode(img, buf);
+        return buf;
+    }
+
+    // Sources of one actor by key name, so images with different key tables compare equal
+    std::map<std::string, const CoSave::Source*> SourcesOf(const CoSave::Image& img, const CoSave::Actor& a) {
+        std::map<std::string, const CoSave::Source*> out;
+        for (std::uint32_t i = 0; i < a.sourceCount; ++i) {
+            const CoSave::Source& s = img.sources[a.firstSource + i];
+            out[img.keys.at(s.key)] = &s;
+        }
+        return out;
+    }
+
+    const CoSave::Actor* Find(const CoSave::Image& img, std::uint32_t formID) {
+        for (const auto& a : img.actors)
+            if (a.formID == formID) return &a;
+        return nullptr;
+    }
+
+    void ExpectSameImage(const CoSave::Image& want, const CoSave::Image& got) {
+        ASSERT_EQ(want.actors.size(), got.actors.size());
+        for (const auto& wa : want.actors) {
+            const CoSave::Actor* ga = Find(got, wa.formID);
+            ASSERT_NE(ga, nullptr) << std::hex << wa.formID;
+            EXPECT_EQ(ga->wetness, wa.wetness);
+            EXPECT_EQ(ga->lastAppliedWet, wa.lastAppliedWet);
+            const auto ws = SourcesOf(want, wa), gs = SourcesOf(got, *ga);
+            ASSERT_EQ(ws.size(), gs.size());
+            for (const auto& [key, w] : ws) {
+                ASSERT_TRUE(gs.contains(key)) << key;
+                const CoSave::Source* g = gs.at(key);
+                EXPECT_EQ(g->value, w->value) << key;
+                EXPECT_EQ(g->remainSec, w->remainSec) << key;
+                EXPECT_EQ(g->catMask, w->catMask) << key;
+                EXPECT_EQ(g->flags, w->flags) << key;
+                for (std::size_t o = 0; o < CoSave::kOverrideCount; ++o) EXPECT_EQ(g->ov[o], w->ov[o]) << key;
+            }
+        }
+    }
+
+    // Rank the save path uses: player first, then by distance, states restored by the load and untouched last
+    double Rank(std::uint32_t formID, const std::map<std::uint32_t, double>& distance) {
+        if (formID == kPlayer) return -1.0;
+        const auto it = distance.find(formID);
+        return it != distance.end() ? it->second : std::numeric_limits<double>::max();
+    }
+}
+
+TEST(CoSave, EmptyRoundTrip) {
+    CoSave::Image img;
+    const auto buf = Encoded(img);
+    EXPECT_EQ(buf.size(), CoSave::EncodedSize(img));
+    CoSave::Image back;
+    back.keys.push_back("stale");
+    ASSERT_TRUE(CoSave::Decode(buf, back));
+    EXPECT_TRUE(back.keys.empty());
+    EXPECT_TRUE(back.actors.empty());
+    EXPECT_TRUE(back.sources.empty());
+}
+
+TEST(CoSave, RoundTripWithoutOverrides) {
+    ImageBuilder b;
+    b.Actor(0xFF00'0800, 0.25f);
+    b.Actor(kPlayer, 1.f).lastAppliedWet = -1.f;
+    b.Source("rain", 0.5f, 30.f).catMask = 0x03;
+    b.Source("potion", 1.f).flags = 0x1234'5678;
+    b.Actor(0x0001'0D62, 0.75f);
+
+    const auto buf = Encoded(b.img);
+    EXPECT_EQ(buf.size(), CoSave::EncodedSize(b.img));
+    CoSave::Image back;
+    ASSERT_TRUE(CoSave::Decode(buf, back));
+    ExpectSameImage(b.img, back);
+
+    // actors come back in FormID order, the delta coding needs it
+    ASSERT_EQ(back.actors.size(), 3u);
+    EXPECT_EQ(back.actors[0].formID, kPlayer);
+    EXPECT_EQ(back.actors[1].formID, 0x0001'0D62u);
+    EXPECT_EQ(back.actors[2].formID, 0xFF00'0800u);
+}
+
+TEST(CoSave, RoundTripWithOverridesAndSharedKeys) {
+    ImageBuilder b;
+    b.Actor(0x100, 0.5f);
+    CoSave::Source& s = b.Source("spell", 0.5f, 12.5f);
+    s.ov[0] = 0.f;  // stored even though it is zero
+    s.ov[3] = 2.5f;
+    s.ov[6] = 100.f;
+    b.Source("lake", 0.f).flags = 1;
+    b.Actor(0x200, 0.5f);
+    b.Source("spell", 0.75f);
+    b.Actor(0x300, 0.5f);
+    b.Source("lake", 0.125f);
+    CoSave::Source& all = b.Source("all", 1.f);
+    std::fill(std::begin(all.ov), std::end(all.ov), 0.5f);
+
+    ASSERT_EQ(b.img.keys.size(), 3u);  // "spell" and "lake" are stored once for two actors
+    const auto buf = Encoded(b.img);
+    EXPECT_EQ(buf.size(), CoSave::EncodedSize(b.img));
+    CoSave::Image back;
+    ASSERT_TRUE(CoSave::Decode(buf, back));
+    EXPECT_EQ(back.keys.size(), 3u);
+    ExpectSameImage(b.img, back);
+
+    // unset overrides cost nothing on disk
+    ImageBuilder plain;
+    plain.Actor(0x100, 0.5f);
+    plain.Source("spell", 0.5f, 12.5f);
+    ImageBuilder one = plain;
+    one.img.sources[0].ov[2] = 1.f;
+    EXPECT_EQ(Encoded(one.img).size(), Encoded(plain.img).size() + sizeof(float));
+}
+
+TEST(CoSave, VarintBoundaries) {
+    // FormID deltas, source counts, key indices, key lengths and flags are all varints
+    const std::uint32_t values[]{0, 1, 0x7F, 0x80, 0x3FFF, 0x4000, 0x1F'FFFF, 0x20'0000, 0x0FFF'FFFF, 0x1000'0000,
+                                 0xFFFF'FFFF};
+    for (const std::uint32_t v : values) {
+        ImageBuilder b;
+        b.Actor(v, 0.5f);
+        b.Source(std::string(std::min<std::uint32_t>(v, 0x4001), 'k'), 0.5f).flags = v;
+
+        const auto buf = Encoded(b.img);
+        EXPECT_EQ(buf.size(), CoSave::EncodedSize(b.img)) << v;
+        CoSave::Image back;
+        ASSERT_TRUE(CoSave::Decode(buf, back)) << v;
+        ASSERT_EQ(back.actors.size(), 1u);
+        EXPECT_EQ(back.actors[0].formID, v);
+        ASSERT_EQ(back.sources.size(), 1u);
+        EXPECT_EQ(back.sources[0].flags, v);
+        EXPECT_EQ(back.keys[0].size(), std::min<std::uint32_t>(v, 0x4001));
+    }
+
+    // the encoded size steps up exactly at the 7-bit boundaries
+    const auto size = [](std::uint32_t formID) {
+        ImageBuilder b;
+        b.Actor(formID, 0.f);
+        return Encoded(b.img).size();
+    };
+    EXPECT_EQ(size(0x80), size(0x7F) + 1);
+    EXPECT_EQ(size(0x4000), size(0x3FFF) + 1);
+    EXPECT_EQ(size(0x20'0000), size(0x1F'FFFF) + 1);
+    EXPECT_EQ(size(0x1000'0000), size(0x0FFF'FFFF) + 1);
+    EXPECT_EQ(size(0xFFFF'FFFF), size(0x1000'0000));
+}
+
+TEST(CoSave, RejectsTruncatedInput) {
+    ImageBuilder b;
+    b.Actor(kPlayer, 1.f);
+    b.Source("rain", 0.5f, 30.f).ov[1] = 0.5f;
+    b.Actor(0x800, 0.5f);
+    const auto buf = Encoded(b.img);
+
+    CoSave::Image back;
+    for (std::size_t n = 0; n < buf.size(); ++n)
+        EXPECT_FALSE(CoSave::Decode(std::span(buf).first(n), back)) << n << " of " << buf.size() << " bytes";
+
+    // cut short with a checksum that matches what is left, so the parser itself has to notice
+    auto resealed = buf;
+    Reseal(resealed);
+    ASSERT_EQ(resealed, buf);
+    const std::size_t body = buf.size() - sizeof(std::uint32_t);
+    for (std::size_t n = sizeof(CoSave::kMagic); n < body; ++n) {
+        std::vector<std::uint8_t> cut(buf.begin(), buf.begin() + static_cast<std::ptrdiff_t>(n));
+        cut.resize(n + sizeof(std::uint32_t));
+        Reseal(cut);
+        EXPECT_FALSE(CoSave::Decode(cut, back)) << "body cut to " << n << " of " << body << " bytes";
+    }
+
+    // trailing bytes are not a valid record either
+    auto longer = buf;
+    longer.push_back(0);
+    EXPECT_FALSE(CoSave::Decode(longer, back));
+    EXPECT_TRUE(CoSave::Decode(buf, back));
+}
+
+TEST(CoSave, RejectsChecksumMismatch) {
+    ImageBuilder b;
+    b.Actor(kPlayer, 1.f);
+    b.Source("rain", 0.5f, 30.f);
+    const auto buf = Encoded(b.img);
+
+    CoSave::Image back;
+    for (std::size_t i = 0; i < buf.size(); ++i) {
+        auto bad = buf;
+        bad[i] ^= 0x01;
+        EXPECT_FALSE(CoSave::Decode(bad, back)) << "bit flipped in byte " << i;
+    }
+
+    // a checksum that matches does not make a bad magic acceptable
+    auto wrongMagic = buf;
+    wrongMagic[0] ^= 0xFF;
+    Reseal(wrongMagic);
+    EXPECT_FALSE(CoSave::Decode(wrongMagic, back));
+}
+
+TEST(CoSave, CompactDropsExpiredAndNegligibleSources) {
+    ImageBuilder b;
+    b.Actor(0x100, 0.5f);
+    b.Source("expiring", 1.f, 0.5f);   // under minRemainSec
+    b.Source("lasting", 1.f, 5.f);
+    b.Source("dry", 0.0004f);          // at or below minValue
+    b.Source("dryButZeroBase", 0.f).flags = 0x8;
+    b.Source("permanent", 0.25f);
+    b.Actor(0x200, 0.0001f);           // dry and only negligible sources: dropped whole
+    b.Source("dry", 0.f);
+    b.Source("expired", 1.f, 0.f);
+    b.Actor(0x300, 0.5f);              // wet without sources stays
+    b.Source("gone", 0.5f, 0.9f);
+
+    CoSave::CompactLimits lim;
+    lim.keepFlags = 0x8;
+    const CoSave::CompactStats st = CoSave::Compact(b.img, lim, [](std::uint32_t) { return 0.0; });
+    EXPECT_EQ(st.actorsDropped, 1u);
+    EXPECT_EQ(st.sourcesDropped, 5u);
+    EXPECT_GT(st.bytesSaved, 0u);
+
+    ASSERT_EQ(b.img.actors.size(), 2u);
+    const CoSave::Actor* a = Find(b.img, 0x100);
+    ASSERT_NE(a, nullptr);
+    const auto kept = SourcesOf(b.img, *a);
+    EXPECT_EQ(kept.size(), 3u);
+    EXPECT_TRUE(kept.contains("lasting"));
+    EXPECT_TRUE(kept.contains("dryButZeroBase"));
+    EXPECT_TRUE(kept.contains("permanent"));
+    ASSERT_NE(Find(b.img, 0x300), nullptr);
+    EXPECT_EQ(Find(b.img, 0x300)->sourceCount, 0u);
+
+    // keys nobody references any more are gone, and the result still round trips
+    EXPECT_EQ(b.img.keys.size(), 3u);
+    CoSave::Image back;
+    ASSERT_TRUE(CoSave::Decode(Encoded(b.img), back));
+    ExpectSameImage(b.img, back);
+}
+
+TEST(CoSave, CompactKeepsTheStrongestSources) {
+    // saveMaxSourcesPerActor: higher value first, then permanent, then the one that lasts longer
+    ImageBuilder b;
+    b.Actor(0x100, 0.5f);
+    b.Source("weak", 0.1f);
+    b.Source("timedLong", 0.5f, 60.f);
+    b.Source("permanent", 0.5f);
+    b.Source("strong", 0.9f, 5.f);
+    b.Source("timedShort", 0.5f, 10.f);
+    b.Actor(0x200, 0.5f);
+    b.Source("only", 0.1f);
+
+    CoSave::CompactLimits lim;
+    lim.maxSourcesPerActor = 3;
+    const CoSave::CompactStats st = CoSave::Compact(b.img, lim, [](std::uint32_t) { return 0.0; });
+    EXPECT_EQ(st.sourcesDropped, 2u);
+    EXPECT_EQ(st.actorsDropped, 0u);
+
+    const auto kept = SourcesOf(b.img, *Find(b.img, 0x100));
+    EXPECT_EQ(kept.size(), 3u);
+    EXPECT_TRUE(kept.contains("strong"));
+    EXPECT_TRUE(kept.contains("permanent"));
+    EXPECT_TRUE(kept.contains("timedLong"));
+    EXPECT_EQ(SourcesOf(b.img, *Find(b.img, 0x200)).size(), 1u);
+}
+
+TEST(CoSave, CompactKeepsActorsByRank) {
+    // saveMaxActors: the player, then the nearest, and restored-but-untouched states only if there is room
+    ImageBuilder b;
+    std::map<std::uint32_t, double> distance;
+    for (std::uint32_t i = 0; i < 6; ++i) {
+        b.Actor(0x1000 + i, 0.5f);
+        b.Source("src" + std::to_string(i), 0.5f);
+        distance[0x1000 + i] = 100.0 * (6 - i);  // later ones are nearer
+    }
+    b.Actor(0x9000, 0.5f);  // pending, no rank entry
+    b.Source("pending", 0.5f);
+    b.Actor(kPlayer, 0.5f);
+    b.Source("player", 0.5f);
+
+    CoSave::CompactLimits lim;
+    lim.maxActors = 4;
+    std::vector<std::uint32_t> asked;
+    const CoSave::CompactStats st = CoSave::Compact(b.img, lim, [&](std::uint32_t id) {
+        asked.push_back(id);
+        return Rank(id, distance);
+    });
+    EXPECT_EQ(asked.size(), 8u);
+    EXPECT_EQ(st.actorsDropped, 4u);
+    EXPECT_EQ(st.sourcesDropped, 4u);
+
+    ASSERT_EQ(b.img.actors.size(), 4u);
+    EXPECT_NE(Find(b.img, kPlayer), nullptr);
+    EXPECT_NE(Find(b.img, 0x1005), nullptr);
+    EXPECT_NE(Find(b.img, 0x1004), nullptr);
+    EXPECT_NE(Find(b.img, 0x1003), nullptr);
+    EXPECT_EQ(Find(b.img, 0x9000), nullptr);
+
+    // each kept actor still owns its own sources, and only their keys are left
+    EXPECT_EQ(b.img.keys.size(), 4u);
+    EXPECT_TRUE(SourcesOf(b.img, *Find(b.img, kPlayer)).contains("player"));
+    EXPECT_TRUE(SourcesOf(b.img, *Find(b.img, 0x1003)).contains("src3"));
+
+    // under the cap the rank is never asked
+    ImageBuilder few;
+    few.Actor(0x9000, 0.5f);
+    few.Actor(kPlayer, 0.5f);
+    asked.clear();
+    CoSave::Compact(few.img, lim, [&](std::uint32_t id) {
+        asked.push_back(id);
+        return 0.0;
+    });
+    EXPECT_TRUE(asked.empty());
+    EXPECT_EQ(few.img.actors.size(), 2u);
+}
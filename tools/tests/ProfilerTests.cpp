@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+
+#include <cctype>
+#include <map>
+#include <sstream>
+
+#include "utils/Profiler.h"
+
+// The Chrome trace writer, on a fixed span of events. Only the writer is built here, SWE_PROFILE is 0.
+namespace {
+    using namespace SWE;
+
+    // Just enough JSON to read the trace back: the parse fails on anything that is not well formed.
+    struct Json {
+        enum class Type { Null, Bool, Number, String, Array, Object } type{Type::Null};
+        std::string text;  // strings, and numbers exactly as written
+        std::vector<Json> items;
+        std::map<std::string, Json> fields;
+
+        const Json& operator[](const std::string& key) const {
+            static const Json kNull;
+            const auto it = fields.find(key);
+            return it != fields.end() ? it->second : kNull;
+        }
+        bool Has(const std::string& key) const { return fields.contains(key); }
+    };
+
+    class JsonParser {
+    public:
+        explicit JsonParser(std::string_view s) : _s(s) {}
+
+        std::optional<Json> Parse() {
+            Json v;
+            if (!Value(v)) return std::nullopt;
+            Space();
+            if (_i != _s.size()) return std::nullopt;
+            return v;
+        }
+
+    private:
+        void Space() {
+            while (_i < _s.size() && std::strchr(" \t\r\n", _s[_i])) ++_i;
+        }
+        bool Eat(char c) {
+            Space();
+            if (_i >= _s.size() || _s[_i] != c) return false;
+            ++_i;
+            return true;
+        }
+        bool Literal(std::string_view word) {
+            if (_s.substr(_i, word.size()) != word) return false;
+            _i += word.size();
+            return true;
+        }
+
+        bool String(std::string& out) {
+            if (!Eat('"')) return false;
+            while (_i < _s.size() && _s[_i] != '"') {
+                if (static_cast<unsigned char>(_s[_i]) < 0x20) return false;
+                if (_s[_i] == '\\') {
+                    if (++_i >= _s.size() || !std::strchr("\"\\/bfnrtu", _s[_i])) return false;
+                }
+                out += _s[_i++];
+            }
+            return Eat('"');
+        }
+
+        bool Number(std::string& out) {
+            const std::size_t start = _i;
+            if (_i < _s.size() && _s[_i] == '-') ++_i;
+            const auto digits = [&] {
+                const std::size_t from = _i;
+                while (_i < _s.size() && std::isdigit(static_cast<unsigned char>(_s[_i]))) ++_i;
+                return _i > from;
+            };
+            if (!digits()) return false;
+            if (_s[start] == '0' || (_s[start] == '-' && _s[start + 1] == '0')) {
+                if (_i - start > (_s[start] == '-' ? 2u : 1u)) return false;  // no leading zeros
+            }
+            if (_i < _s.size() && _s[_i] == '.' && (++_i, !digits())) return false;
+            if (_i < _s.size() && (_s[_i] == 'e' || _s[_i] == 'E')) {
+                ++_i;
+                if (_i < _s.size() && (_s[_i] == '+' || _s[_i] == '-')) ++_i;
+                if (!digits()) return false;
+            }
+            out = std::string(_s.substr(start, _i - start));
+            return true;
+        }
+
+        bool Value(Json& v) {
+            Space();
+            if (_i >= _s.size()) return false;
+            switch (_s[_i]) {
+                case '{': {
+                    v.type = Json::Type::Object;
+                    ++_i;
+                    if (Eat('}')) return true;
+                    do {
+                        std::string key;
+                        Json item;
+                        if (!String(key) || !Eat(':') || !Value(item)) return false;
+                        if (!v.fields.emplace(std::move(key), std::move(item)).second) return false;
+                    } while (Eat(','));
+                    return Eat('}');
+                }
+                case '[': {
+                    v.type = Json::Type::Array;
+                    ++_i;
+                    if (Eat(']')) return true;
+                    do {
+                        if (!Value(v.items.emplace_back())) return false;
+                    } while (Eat(','));
+                    return Eat(']');
+                }
+                case '"':
+                    v.type = Json::Type::String;
+                    return String(v.text);
+                case 't':
+                case 'f':
+                    v.type = Json::Type::Bool;
+                    return Literal("true") || Literal("false");
+                case 'n':
+                    return Literal("null");
+                default:
+                    v.type = Json::Type::Number;
+                    return Number(v.text);
+            }
+        }
+
+        std::string_view _s;
+        std::size_t _i{0};
+    };
+
+    Prof::TraceEvent Event(Prof::Phase phase, std::uint64_t startNs, std::uint64_t durNs, std::uint32_t formID = 0) {
+        Prof::TraceEvent e;
+        e.phase = phase;
+        e.startNs = startNs;
+        e.durNs = durNs;
+        e.formID = formID;
+        return e;
+    }
+
+    Json Trace(std::span<const Prof::TraceEvent> events, std::uint64_t dropped = 0) {
+        std::ostringstream os;
+        Prof::WriteChromeTrace(os, events, dropped);
+        auto json = JsonParser(os.str()).Parse();
+        EXPECT_TRUE(json) << os.str();
+        return json ? *json : Json{};
+    }
+}
+
+TEST(Profiler, EmptyTraceIsValid) {
+    const Json trace = Trace({});
+    ASSERT_EQ(trace.type, Json::Type::Object);
+    EXPECT_EQ(trace["displayTimeUnit"].text, "ms");
+    EXPECT_EQ(trace["otherData"]["dropped"].text, "0");
+    EXPECT_EQ(trace["traceEvents"].type, Json::Type::Array);
+    EXPECT_TRUE(trace["traceEvents"].items.empty());
+}
+
+TEST(Profiler, EventsAreCompleteEventsInMicroseconds) {
+    const std::vector<Prof::TraceEvent> events{
+        Event(Prof::Phase::Tick, 0, 1'234'567),
+        Event(Prof::Phase::ProbeRoof, 1'000, 999),
+        Event(Prof::Phase::ApplyMaterials, 12'345'678'901'234, 5),
+    };
+    const Json trace = Trace(events);
+    const auto& out = trace["traceEvents"].items;
+    ASSERT_EQ(out.size(), 3u);
+
+    for (const Json& e : out) {
+        EXPECT_EQ(e["ph"].text, "X");
+        EXPECT_EQ(e["cat"].text, "swe");
+        EXPECT_EQ(e["pid"].text, "1");
+        EXPECT_EQ(e["tid"].text, "1");
+        EXPECT_EQ(e["ts"].type, Json::Type::Number);
+        EXPECT_EQ(e["dur"].type, Json::Type::Number);
+    }
+    EXPECT_EQ(out[0]["name"].text, "Tick");
+    EXPECT_EQ(out[1]["name"].text, "ProbeRoof");
+    EXPECT_EQ(out[2]["name"].text, "ApplyMaterials");
+
+    // nanoseconds become microseconds with three decimals, never in exponent form
+    EXPECT_EQ(out[0]["ts"].text, "0.000");
+    EXPECT_EQ(out[0]["dur"].text, "1234.567");
+    EXPECT_EQ(out[1]["ts"].text, "1.000");
+    EXPECT_EQ(out[1]["dur"].text, "0.999");
+    EXPECT_EQ(out[2]["ts"].text, "12345678901.234");
+    EXPECT_EQ(out[2]["dur"].text, "0.005");
+}
+
+TEST(Profiler, ArgsOnlyWhenSet) {
+    std::vector<Prof::TraceEvent> events{
+        Event(Prof::Phase::UpdateActor, 0, 10),
+        Event(Prof::Phase::UpdateActor, 10, 10, 0x0001'0D62),
+        Event(Prof::Phase::StampProbe, 20, 10),
+        Event(Prof::Phase::UpdateActor, 30, 10, 0xFF00'0014),
+    };
+    events[2].counts[static_cast<std::size_t>(Prof::Counter::Rays)] = 3;
+    events[3].counts[static_cast<std::size_t>(Prof::Counter::Refs)] = 120;
+    events[3].counts[static_cast<std::size_t>(Prof::Counter::Geometries)] = 7;
+
+    const Json trace = Trace(events);
+    const auto& out = trace["traceEvents"].items;
+    ASSERT_EQ(out.size(), 4u);
+
+    EXPECT_EQ(out[0]["args"].type, Json::Type::Object);
+    EXPECT_TRUE(out[0]["args"].fields.empty());
+
+    ASSERT_EQ(out[1]["args"].fields.size(), 1u);
+    EXPECT_EQ(out[1]["args"]["formID"].text, "00010D62");
+
+    ASSERT_EQ(out[2]["args"].fields.size(), 1u);
+    EXPECT_FALSE(out[2]["args"].Has("formID"));
+    EXPECT_EQ(out[2]["args"]["rays"].text, "3");
+
+    ASSERT_EQ(out[3]["args"].fields.size(), 3u);
+    EXPECT_EQ(out[3]["args"]["formID"].text, "FF000014");
+    EXPECT_EQ(out[3]["args"]["refs"].text, "120");
+    EXPECT_EQ(out[3]["args"]["geometries"].text, "7");
+    EXPECT_FALSE(out[3]["args"].Has("rays"));
+}
+
+TEST(Profiler, DroppedCountIsReported) {
+    const std::vector<Prof::TraceEvent> events{Event(Prof::Phase::Tick, 0, 1)};
+    const Json trace = Trace(events, 4096);
+    EXPECT_EQ(trace["otherData"]["dropped"].text, "4096");
+    EXPECT_EQ(trace["traceEvents"].items.size(), 1u);
+}
+
+TEST(Profiler, PhaseNames) {
+    EXPECT_STREQ(Prof::PhaseName(Prof::Phase::Tick), "Tick");
+    EXPECT_STREQ(Prof::PhaseName(Prof::Phase::ApplyMaterials), "ApplyMaterials");
+    EXPECT_STREQ(Prof::PhaseName(Prof::Phase::kCount), "?");
+}
@@ -0,0 +1,333 @@
+#include <gtest/gtest.h>
+
+#include <map>
+
+#include "replay/Replay.h"
+
+// A recording has to carry everything the simulation reads: a scripted session is run the way WetController ticks,
+// recorded, and replayed from the file alone, which has to end in the same state.
+namespace {
+    using namespace SWE;
+
+    constexpr std::uint32_t kPlayer = 0x14, kGuard = 0xFF001000, kGuardBase = 0x0001A2B3, kBard = 0xFF001001,
+                            kCourier = 0xFF001002;
+
+    // WetController's side: the state it keeps, the records it writes, the steps it runs
+    struct Game {
+        Settings::Config cfg;
+        Settings::ActorListsSnapshot lists;
+        std::unordered_map<std::uint32_t, Replay::Actor> actors;
+        std::unordered_map<std::uint32_t, std::uint32_t> captured;  // WetData::recSession
+        double clock{1000.0};
+        float dt{0.f};
+        float step{0.f};
+
+        void Tick(float tickDt) {
+            dt = tickDt;
+            step = static_cast<float>(cfg.tickIntervalMs) / 1000.f * 21.f;
+            clock += dt;
+            Rec::Config(cfg);
+            Rec::ActorLists(lists);
+            Rec::Tick(dt, 0.f, step);
+        }
+
+        void Capture(std::uint32_t id, const Replay::Actor& wd) {
+            Rec::StateRec st;
+            st.wetness = wd.wetness;
+            st.lastAppliedWet = wd.lastAppliedWet;
+            std::copy(std::begin(wd.lastAppliedCat), std::end(wd.lastAppliedCat), st.lastAppliedCat);
+            std::copy(std::begin(wd.simCat), std::end(wd.simCat), st.simCat);
+            st.simInit = wd.simInit;
+            st.activityLevel = wd.activityLevel;
+            st.simAge = (wd.simTime < 0.0) ? -1.0 : clock - wd.simTime;
+            st.envClass = static_cast<std::uint8_t>(wd.envClass);
+            for (const auto& [key, s] : wd.extSources)
+                st.sources.push_back({key, s.value, s.expiryRemainingSec, s.catMask, s.flags});
+            Rec::State(id, st);
+        }
+
+        void Update(std::uint32_t id, std::uint32_t baseID, std::uint16_t env, std::uint8_t activity = 0,
+                    bool geomChanged = false) {
+            Replay::Actor& wd = actors[id];
+            if (Rec::IsRecording() && captured[id] != Rec::Session()) {
+                captured[id] = Rec::Session();
+                Capture(id, wd);
+            }
+            Sim::SettleActor(wd, clock - dt, step, cfg);
+
+            Sim::ActorInput in;
+            in.clock = clock;
+            in.dt = dt;
+            in.step = step;
+            in.allowEnvWet = (env & Rec::kEnvAllowEnv) != 0;
+            in.inWater = (env & Rec::kEnvWater) != 0;
+            in.nearWaterfall = (env & Rec::kEnvWaterfall) != 0;
+            in.exposed = (env & Rec::kEnvExposed) != 0;
+            in.rain = (env & Rec::kEnvRain) != 0;
+            in.snow = (env & Rec::kEnvSnow) != 0;
+            in.nearHeat = (env & Rec::kEnvNearHeat) != 0;
+            in.active = activity != 0;
+            const Sim::Policy p = Sim::ResolvePolicy(lists, id, baseID);
+            in.forced = (env & Rec::kEnvManual) && p.hasOverride;
+            in.forcedWet = p.forcedWet;
+            in.forcedMask = p.forcedMask;
+
+            float out[4];
+            const float w = Sim::UpdateActor(wd, in, cfg, out);
+            wd.wetness = w;
+            Rec::Actor(id, baseID, env, 0.f, activity);
+            if (geomChanged) Rec::GeomChanged(id);
+            Sim::CommitApplied(wd, out, w, geomChanged && w > Sim::kDryWetness);
+        }
+
+        void SetSource(Rec::ExtOp op, std::uint32_t id, const std::string& key, float value, float duration,
+                       std::uint8_t catMask, std::uint32_t flags = 0) {
+            auto& src = actors[id].extSources[key];
+            src = {value, duration > 0.f ? duration : -1.f, catMask, flags};
+            Rec::External(op, id, key, src.value, src.expiryRemainingSec, src.catMask, src.flags);
+        }
+
+        void Clear(std::uint32_t id, const std::string& key) {
+            if (actors[id].extSources.erase(key)) Rec::External(Rec::ExtOp::Clear, id, key, 0.f, 0.f, 0, 0);
+        }
+
+        void Deselect(std::uint32_t id) {
+            auto& wd = actors[id];
+            wd.wetness = wd.lastAppliedWet = 0.f;
+            std::fill(std::begin(wd.lastAppliedCat), std::end(wd.lastAppliedCat), 0.f);
+            wd.extSources.clear();
+            Rec::Deselect(id);
+        }
+    };
+
+    Settings::Config MakeConfig(std::uint64_t version, float secondsToDrySkin) {
+        Settings::Config cfg;
+        cfg.version = version;
+        cfg.secondsToDrySkin = secondsToDrySkin;
+        cfg.secondsToSoakRain = 45.f;
+        cfg.activityWetEnabled = true;
+        cfg.activityCatMask = 0x03;
+        cfg.externalBlendMode = 2;
+        Settings::DeriveConfig(cfg);
+        return cfg;
+    }
+
+    Settings::FormSpec Spec(std::uint32_t id, float value, std::uint8_t mask, bool autoWet) {
+        Settings::FormSpec fs;
+        fs.plugin = "Test.esp";
+        fs.id = id;
+        fs.value = value;
+        fs.mask = mask;
+        fs.autoWet = autoWet;
+        return fs;
+    }
+
+    std::filesystem::path TempFile(const char* name) { return std::filesystem::temp_directory_path() / name; }
+
+    void ExpectSameState(const Replay::Actor& game, const Replay::Actor& replayed, std::uint32_t id) {
+        SCOPED_TRACE(testing::Message() << std::hex << id);
+        EXPECT_NEAR(game.wetness, replayed.wetness, 1e-5f);
+        EXPECT_NEAR(game.lastAppliedWet, replayed.lastAppliedWet, 1e-5f);
+        EXPECT_NEAR(game.activityLevel, replayed.activityLevel, 1e-5f);
+        EXPECT_EQ(game.simInit, replayed.simInit);
+        EXPECT_EQ(game.envClass, replayed.envClass);
+        for (int ci = 0; ci < 4; ++ci) {
+            EXPECT_NEAR(game.simCat[ci], replayed.simCat[ci], 1e-5f) << "category " << ci;
+            EXPECT_NEAR(game.lastAppliedCat[ci], replayed.lastAppliedCat[ci], 1e-5f) << "category " << ci;
+        }
+        ASSERT_EQ(game.extSources.size(), replayed.extSources.size());
+        for (const auto& [key, s] : game.extSources) {
+            ASSERT_TRUE(replayed.extSources.contains(key)) << key;
+            const auto& r = replayed.extSources.at(key);
+            EXPECT_NEAR(s.value, r.value, 1e-5f) << key;
+            EXPECT_NEAR(s.expiryRemainingSec, r.expiryRemainingSec, 1e-3f) << key;
+            EXPECT_EQ(s.catMask, r.catMask) << key;
+            EXPECT_EQ(s.flags, r.flags) << key;
+        }
+    }
+}
+
+TEST(Recorder, RoundTrip) {
+    const auto path = TempFile("swe_recorder_roundtrip.swerec");
+    ASSERT_TRUE(Rec::Start(path));
+    const std::uint32_t session = Rec::Session();
+
+    const Settings::Config cfg = MakeConfig(7, 33.f);
+    Settings::ActorListsSnapshot lists;
+    lists.version = 3;
+    lists.overrides.push_back(Spec(kGuardBase, 0.6f, 0x05, false));
+    lists.tracked.push_back(Spec(kGuard, 0.f, 0x0F, false));
+    lists.enabledIDs = {kGuard, kGuardBase};
+
+    Rec::Config(cfg);
+    Rec::Config(cfg);  // same version: not written again
+    Rec::ActorLists(lists);
+    Rec::Tick(0.25f, 0.2f, 0.21f);
+    Rec::StateRec st;
+    st.wetness = 0.4f;
+    st.simCat[2] = 0.4f;
+    st.simInit = true;
+    st.simAge = 2.5;
+    st.envClass = static_cast<std::uint8_t>(Sim::EnvClass::kPrecip);
+    st.sources.push_back({"mod.rain", 0.3f, 12.f, 0x04, Sim::kFlagNoAutoDry});
+    Rec::State(kGuard, st);
+    Rec::Actor(kGuard, kGuardBase, Rec::kEnvRain | Rec::kEnvExposed | Rec::kEnvManual, 0.f, Rec::kActRun);
+    Rec::GeomChanged(kGuard);
+    Rec::Deselect(kBard);
+    Rec::External(Rec::ExtOp::SetMask, kBard, "mod.splash", 0.5f, 4.f, 0x03, Sim::kFlagPassthrough);
+    Rec::Stop();
+
+    std::ifstream is(path, std::ios::binary);
+    Rec::Reader reader(is);
+    ASSERT_TRUE(reader.Valid());
+    EXPECT_EQ(reader.Version(), Rec::kVersion);
+
+    std::string tags;
+    Rec::Record r;
+    while (reader.Next(r)) {
+        tags += r.tag;
+        switch (r.tag) {
+            case 'C':
+                EXPECT_EQ(r.config.version, 7u);
+                EXPECT_FLOAT_EQ(r.config.secondsToDrySkin, 33.f);
+                EXPECT_FLOAT_EQ(r.config.dryRate[0], cfg.dryRate[0]);  // derived again on read
+                EXPECT_TRUE(r.config.activityWetEnabled);
+                EXPECT_EQ(r.config.activityMask, 0x03);
+                EXPECT_EQ(r.config.externalBlendMode, 2);
+                break;
+            case 'L':
+                EXPECT_EQ(r.lists.version, 3u);
+                ASSERT_EQ(r.lists.overrides.size(), 1u);
+                EXPECT_EQ(r.lists.overrides[0].plugin, "Test.esp");
+                EXPECT_EQ(r.lists.overrides[0].id, kGuardBase);
+                EXPECT_EQ(r.lists.overrides[0].mask, 0x05);
+                EXPECT_FALSE(r.lists.overrides[0].autoWet);
+                ASSERT_EQ(r.lists.tracked.size(), 1u);
+                EXPECT_EQ(r.lists.enabledIDs, lists.enabledIDs);
+                break;
+            case 'T':
+                EXPECT_FLOAT_EQ(r.tick.stepDt, 0.21f);
+                break;
+            case 'S':
+                EXPECT_EQ(r.state.formID, kGuard);
+                EXPECT_DOUBLE_EQ(r.state.simAge, 2.5);
+                ASSERT_EQ(r.state.sources.size(), 1u);
+                EXPECT_EQ(r.state.sources[0].key, "mod.rain");
+                EXPECT_EQ(r.state.sources[0].flags, Sim::kFlagNoAutoDry);
+                break;
+            case 'A':
+                EXPECT_EQ(r.actor.baseID, kGuardBase);
+                EXPECT_EQ(r.actor.activity, Rec::kActRun);
+                break;
+            case 'G':
+                EXPECT_EQ(r.formID, kGuard);
+                break;
+            case 'D':
+                EXPECT_EQ(r.formID, kBard);
+                break;
+            case 'X':
+                EXPECT_EQ(r.ext.key, "mod.splash");
+                EXPECT_EQ(r.ext.flags, Sim::kFlagPassthrough);
+                break;
+        }
+    }
+    EXPECT_TRUE(is.eof());
+    EXPECT_EQ(tags, "CLTSAGDX");
+
+    // a new recording writes both again and counts a new session
+    ASSERT_TRUE(Rec::Start(path));
+    EXPECT_EQ(Rec::Session(), session + 1);
+    Rec::Config(cfg);
+    Rec::ActorLists(lists);
+    Rec::Stop();
+    std::ifstream again(path, std::ios::binary);
+    Rec::Reader second(again);
+    tags.clear();
+    while (second.Next(r)) tags += r.tag;
+    EXPECT_EQ(tags, "CL");
+    std::filesystem::remove(path);
+}
+
+TEST(Replay, EndsWhereTheRecordedSessionEnded) {
+    Game g;
+    g.cfg = MakeConfig(1, 30.f);
+    g.lists.version = 1;
+    const std::uint16_t autoEnv = Rec::kEnvAllowEnv;
+    const std::uint16_t rain = autoEnv | Rec::kEnvRain | Rec::kEnvExposed;
+
+    // state from before the recording starts only reaches the replay through the 'S' records; the bard left the
+    // rain some ticks before, so its first update settles that gap
+    for (int i = 0; i < 40; ++i) {
+        g.Tick(0.21f);
+        g.Update(kPlayer, 0x7, i < 35 ? autoEnv | Rec::kEnvWater : autoEnv, i < 35 ? 0 : Rec::kActRun);
+        if (i < 30) g.Update(kBard, 0x8, rain);
+        g.Update(kCourier, 0x9, autoEnv | Rec::kEnvWater);
+    }
+    g.SetSource(Rec::ExtOp::SetMask, kBard, "mod.perfume", 0.35f, 0.f, 0x01);
+
+    // the state after these ticks is compared, most of it has dried off by the end
+    std::map<std::size_t, std::unordered_map<std::uint32_t, Replay::Actor>> checkpoints;
+    const std::size_t kCheckpoints[]{0, 1, 10, 75, 130, 200, 299, 300, 399};
+
+    const auto path = TempFile("swe_replay_session.swerec");
+    ASSERT_TRUE(Rec::Start(path));
+    for (std::size_t i = 0; i < 400; ++i) {
+        // a hitch, then a wait of an in-game hour that the catch-up integrates
+        g.Tick(i == 150 ? 3.f : i == 300 ? 3600.f : 0.21f);
+
+        const bool raining = i >= 20 && i < 100;
+        g.Update(kPlayer, 0x7, raining ? rain : (i < 200 ? autoEnv | Rec::kEnvNearHeat : autoEnv),
+                 (i >= 120 && i < 180) ? Rec::kActRun : 0, i == 130);
+        // new equipment on a slowly drying actor: every category is applied, not only the ones that moved enough
+        if (i >= 50) g.Update(kGuard, kGuardBase, Rec::kEnvManual, i > 260 ? Rec::kActWork : 0, i == 200);
+        if (i < 320 && i % 3 == 0) g.Update(kBard, 0x8, autoEnv);  // sometimes out of range
+        if (i < 330) g.Update(kCourier, 0x9, autoEnv);
+
+        if (i == 60) g.SetSource(Rec::ExtOp::SetMask, kGuard, "mod.splash", 0.8f, 20.f, 0x0F, Sim::kFlagZeroBase);
+        if (i == 80) g.SetSource(Rec::ExtOp::Set, kBard, "mod.sweat", 0.2f, 0.f, 0x01);
+        if (i == 90) g.SetSource(Rec::ExtOp::SetEx, kPlayer, "mod.oil", 0.5f, 600.f, 0x04, Sim::kFlagPassthrough);
+        if (i == 140) g.Clear(kBard, "mod.sweat");
+        if (i == 310) g.SetSource(Rec::ExtOp::Set, kCourier, "mod.mud", 0.4f, 0.f, 0x01);
+        if (i == 110) {
+            // the guard goes manual with a forced value from its base
+            g.lists.version = 2;
+            g.lists.tracked.push_back(Spec(kGuard, 0.f, 0x0F, false));
+            g.lists.overrides.push_back(Spec(kGuardBase, 0.7f, 0x05, false));
+        }
+        if (i == 250) g.cfg = MakeConfig(2, 90.f);
+        if (i == 330) g.Deselect(kCourier);
+        if (std::ranges::find(kCheckpoints, i) != std::end(kCheckpoints)) checkpoints[i] = g.actors;
+    }
+    Rec::Stop();
+
+    std::ifstream is(path, std::ios::binary);
+    Rec::Reader reader(is);
+    ASSERT_TRUE(reader.Valid());
+    Replay::Player player;
+    auto compare = [&](std::size_t tick) {
+        SCOPED_TRACE(testing::Message() << "after tick " << tick);
+        for (const auto& [id, a] : checkpoints.at(tick)) {
+            ASSERT_TRUE(player.Actors().contains(id));
+            ExpectSameState(a, player.Actors().at(id), id);
+        }
+    };
+    Rec::Record r;
+    while (reader.Next(r)) {
+        // a tick is complete once the next one starts
+        if (r.tag == 'T' && !player.Ticks().empty() && checkpoints.contains(player.Ticks().size() - 1))
+            compare(player.Ticks().size() - 1);
+        EXPECT_TRUE(player.Apply(r)) << r.tag;
+    }
+    EXPECT_TRUE(is.eof());
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(player.Ticks().size(), 400u);
+    EXPECT_EQ(player.Config().version, 2u);
+    EXPECT_EQ(player.Lists().version, 2u);
+    EXPECT_EQ(player.Actors().size(), 4u);
+    compare(399);
+    // the forced override from the recorded lists is what the guard shows, the source set before the recording
+    // started is still on the bard
+    EXPECT_FLOAT_EQ(player.Actors().at(kGuard).lastAppliedCat[0], 0.7f);
+    EXPECT_TRUE(player.Actors().at(kBard).extSources.contains("mod.perfume"));
+}
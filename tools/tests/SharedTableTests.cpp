@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "utils/SharedTable.h"
+
+// The writer in utils/SharedTable against the reader in the public header, through the real named mapping.
+namespace {
+    using namespace SWE;
+
+    Shared::Entry Row(std::uint32_t formID, std::uint64_t lastSeenMs, float wetness = 0.5f) {
+        Shared::Entry e;
+        e.formID = formID;
+        e.wetness = wetness;
+        e.lastSeenMs = lastSeenMs;
+        return e;
+    }
+
+    // A second writable view of the table, standing in for a writer caught mid-update or one that died
+    struct RawMapping {
+        explicit RawMapping(std::size_t rows, bool create = false) {
+            size = sizeof(Shared::Header) + rows * sizeof(Shared::Entry);
+            const int fd = shm_open(Shared::kMappingName, O_RDWR | (create ? O_CREAT : 0), 0644);
+            if (fd < 0) return;
+            if (!create || ftruncate(fd, static_cast<off_t>(size)) == 0) {
+                void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (p != MAP_FAILED) header = static_cast<Shared::Header*>(p);
+            }
+            ::close(fd);
+        }
+        ~RawMapping() {
+            if (header) munmap(header, size);
+        }
+        RawMapping(const RawMapping&) = delete;
+        RawMapping& operator=(const RawMapping&) = delete;
+
+        Shared::Header* header{nullptr};
+        std::size_t size{0};
+    };
+
+    class SharedTableTest : public testing::Test {
+    protected:
+        void SetUp() override {
+            SharedTable::Close();
+            shm_unlink(Shared::kMappingName);
+        }
+        void TearDown() override {
+            SharedTable::Close();
+            shm_unlink(Shared::kMappingName);
+        }
+    };
+}
+
+TEST_F(SharedTableTest, ReaderNeedsTheWriter) {
+    Shared::Reader reader;
+    EXPECT_FALSE(reader.Open());
+
+    ASSERT_TRUE(SharedTable::Open(8));
+    ASSERT_TRUE(reader.Open());
+    const Shared::Header* h = reader.GetHeader();
+    EXPECT_EQ(h->magic, Shared::kMagic);
+    EXPECT_EQ(h->version, Shared::kVersion);
+    EXPECT_EQ(h->capacity, 8u);
+    EXPECT_EQ(h->entryStride, sizeof(Shared::Entry));
+    EXPECT_EQ(h->seq.load() % 2, 0u);
+
+    std::vector<Shared::Entry> rows{Row(1, 1)};
+    ASSERT_TRUE(reader.Snapshot(rows));
+    EXPECT_TRUE(rows.empty());
+}
+
+TEST_F(SharedTableTest, SnapshotSeesThePublishedRows) {
+    ASSERT_TRUE(SharedTable::Open(8));
+    Shared::Reader reader;
+    ASSERT_TRUE(reader.Open());
+
+    const std::vector<Shared::Entry> published{Row(0x14, 100, 1.f), Row(0x0100'0D62, 90, 0.25f)};
+    SharedTable::Publish(published, 42);
+
+    std::vector<Shared::Entry> rows;
+    std::uint64_t publishedMs = 0, stateVersion = 0;
+    ASSERT_TRUE(reader.Snapshot(rows, &publishedMs, &stateVersion));
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0].formID, 0x14u);
+    EXPECT_EQ(rows[0].wetness, 1.f);
+    EXPECT_EQ(rows[1].formID, 0x0100'0D62u);
+    EXPECT_EQ(rows[1].wetness, 0.25f);
+    EXPECT_EQ(rows[1].lastSeenMs, 90u);
+    EXPECT_EQ(stateVersion, 42u);
+    EXPECT_GT(publishedMs, 0u);
+
+    // the next publish replaces the table, it does not append
+    SharedTable::Publish(std::span(published).first(1), 43);
+    ASSERT_TRUE(reader.Snapshot(rows, nullptr, &stateVersion));
+    EXPECT_EQ(rows.size(), 1u);
+    EXPECT_EQ(stateVersion, 43u);
+}
+
+TEST_F(SharedTableTest, ReaderRetriesWhileTheWriterIsBusy) {
+    ASSERT_TRUE(SharedTable::Open(4));
+    SharedTable::Publish(std::vector{Row(1, 1)}, 1);
+    Shared::Reader reader;
+    ASSERT_TRUE(reader.Open());
+    RawMapping writer(4);
+    ASSERT_NE(writer.header, nullptr);
+
+    // an odd seq is a write in progress: nothing is accepted however often the reader tries
+    const std::uint32_t s = writer.header->seq.load();
+    writer.header->seq.store(s + 1);
+    std::vector<Shared::Entry> rows;
+    EXPECT_FALSE(reader.Snapshot(rows, nullptr, nullptr, 1000));
+
+    // and the reader gets the finished write once the writer is done
+    std::thread finish([&] {
+        std::this_thread::sleep_for(20ms);
+        auto* dst = reinterpret_cast<Shared::Entry*>(reinterpret_cast<std::uint8_t*>(writer.header) +
+                                                     writer.header->headerSize);
+        dst[0] = Row(7, 7);
+        dst[1] = Row(8, 8);
+        writer.header->count = 2;
+        writer.header->stateVersion = 2;
+        writer.header->seq.store(s + 2, std::memory_order_release);
+    });
+    std::uint64_t stateVersion = 0;
+    const bool ok = reader.Snapshot(rows, nullptr, &stateVersion, std::numeric_limits<int>::max());
+    finish.join();
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0].formID, 7u);
+    EXPECT_EQ(rows[1].formID, 8u);
+    EXPECT_EQ(stateVersion, 2u);
+}
+
+TEST_F(SharedTableTest, ReopenedMappingKeepsCountingSeq) {
+    // a table left behind by a writer that died inside an update
+    {
+        RawMapping stale(4, true);
+        ASSERT_NE(stale.header, nullptr);
+        stale.header->seq.store(41);
+    }
+    ASSERT_TRUE(SharedTable::Open(4));
+    Shared::Reader reader;
+    ASSERT_TRUE(reader.Open());
+    EXPECT_EQ(reader.GetHeader()->seq.load(), 42u);
+    EXPECT_EQ(reader.GetHeader()->count, 0u);
+
+    SharedTable::Publish(std::vector{Row(1, 1)}, 1);
+    EXPECT_EQ(reader.GetHeader()->seq.load(), 44u);
+
+    // one that finished its last update cleanly
+    SharedTable::Close();
+    {
+        RawMapping stale(4, true);
+        ASSERT_NE(stale.header, nullptr);
+        stale.header->seq.store(100);
+    }
+    ASSERT_TRUE(SharedTable::Open(4));
+    ASSERT_TRUE(reader.Open());
+    EXPECT_EQ(reader.GetHeader()->seq.load(), 102u);
+}
+
+TEST_F(SharedTableTest, PublishStopsAtCapacity) {
+    ASSERT_TRUE(SharedTable::Open(3));
+    EXPECT_EQ(SharedTable::Capacity(), 3u);
+    Shared::Reader reader;
+    ASSERT_TRUE(reader.Open());
+
+    std::vector<Shared::Entry> published;
+    for (std::uint32_t i = 1; i <= 5; ++i) published.push_back(Row(i, i));
+    SharedTable::Publish(published, 1);
+
+    std::vector<Shared::Entry> rows;
+    ASSERT_TRUE(reader.Snapshot(rows));
+    ASSERT_EQ(rows.size(), 3u);
+    for (std::uint32_t i = 0; i < 3; ++i) EXPECT_EQ(rows[i].formID, i + 1);
+}
+
+TEST_F(SharedTableTest, TrimKeepsTheMostRecentlySeen) {
+    // sharedTableMaxActors rows: the most recently seen actors make the cut, in FormID order
+    std::vector<Shared::Entry> rows{Row(0x50, 10), Row(0x14, 500), Row(0x30, 300), Row(0x40, 20), Row(0x20, 400)};
+    SharedTable::Trim(rows, 3);
+    ASSERT_EQ(rows.size(), 3u);
+    EXPECT_EQ(rows[0].formID, 0x14u);
+    EXPECT_EQ(rows[1].formID, 0x20u);
+    EXPECT_EQ(rows[2].formID, 0x30u);
+
+    // under the cap nothing is dropped, only sorted
+    std::vector<Shared::Entry> few{Row(0x30, 1), Row(0x10, 2)};
+    SharedTable::Trim(few, 3);
+    ASSERT_EQ(few.size(), 2u);
+    EXPECT_EQ(few[0].formID, 0x10u);
+    EXPECT_EQ(few[1].formID, 0x30u);
+
+    ASSERT_TRUE(SharedTable::Open(3));
+    SharedTable::Trim(rows, SharedTable::Capacity());
+    SharedTable::Publish(rows, 1);
+    Shared::Reader reader;
+    ASSERT_TRUE(reader.Open());
+    std::vector<Shared::Entry> read;
+    ASSERT_TRUE(reader.Snapshot(read));
+    ASSERT_EQ(read.size(), 3u);
+    EXPECT_EQ(read[2].formID, 0x30u);
+}
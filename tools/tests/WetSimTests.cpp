@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <map>
+
+#include "utils/WetSim.h"
+
+// The closed-form catch-up (Sim::CatchUp / Sim::AdvanceCat) against the regular tick it replaces: ExpireSources and
+// Step once per step, for as many steps as the interval holds.
+namespace {
+    using namespace SWE;
+
+    struct Source {
+        float value{0.f};
+        float expiryRemainingSec{-1.f};
+        std::uint8_t catMask{0x0F};
+        std::uint32_t flags{0};
+    };
+    using Sources = std::map<std::string, Source>;
+
+    constexpr float kStep = 0.01f * (1.f + 20.f);  // 10 ms ticks at timescale 20
+    constexpr float kTolerance = 2e-4f;
+
+    struct Actor {
+        float cat[4]{1.f, 1.f, 1.f, 1.f};
+        float last[4]{1.f, 1.f, 1.f, 1.f};
+        Sources sources;
+    };
+
+    Settings::Config MakeConfig(int blendMode = 0) {
+        Settings::Config cfg;
+        const float dryTimes[4]{60.f, 90.f, 120.f, 30.f};
+        for (int ci = 0; ci < 4; ++ci) cfg.dryRate[ci] = 1.f / dryTimes[ci];
+        cfg.externalBlendMode = blendMode;
+        cfg.externalAddWeight = 0.5f;
+        return cfg;
+    }
+
+    void Fine(Actor& a, int steps, float dryMul, const Settings::Config& cfg) {
+        float out[4];
+        for (int i = 0; i < steps; ++i) {
+            Sim::ExpireSources(a.sources, kStep);
+            Sim::Step(a.cat, a.last, a.sources, kStep, dryMul, cfg, out);
+        }
+    }
+
+    void Closed(Actor& a, int steps, float dryMul, const Settings::Config& cfg) {
+        const float span = static_cast<float>(steps) * kStep;
+        Sim::CatchUp(a.cat, a.last, a.sources, span, kStep, dryMul, cfg);
+        Sim::ExpireSources(a.sources, span);
+    }
+
+    // Runs both from the same start and checks every category, and that the same sources are left.
+    void ExpectSame(const Actor& start, int steps, float dryMul = 1.f, const Settings::Config& cfg = MakeConfig()) {
+        Actor fine = start, closed = start;
+        Fine(fine, steps, dryMul, cfg);
+        Closed(closed, steps, dryMul, cfg);
+        for (int ci = 0; ci < 4; ++ci)
+            EXPECT_NEAR(fine.cat[ci], closed.cat[ci], kTolerance) << "category " << ci << " after " << steps;
+        ASSERT_EQ(fine.sources.size(), closed.sources.size());
+        for (const auto& [key, s] : fine.sources) {
+            ASSERT_TRUE(closed.sources.contains(key)) << key;
+            EXPECT_NEAR(s.expiryRemainingSec, closed.sources.at(key).expiryRemainingSec, 1e-2f) << key;
+        }
+    }
+
+    const int kSpans[]{5, 37, 300, 2000, 20000};  // ~1 s to ~70 min of game time
+}
+
+TEST(WetSim, AdvanceCatSingleStepMatchesTheRecurrence) {
+    const float s = 0.7f, rate = 0.05f, floor = 0.2f, add = 0.01f;
+    const float expect = Sim::Clamp01(std::max(Sim::Clamp01(s - rate * kStep), floor) + add);
+    EXPECT_FLOAT_EQ(Sim::AdvanceCat(s, kStep, kStep, rate, floor, add), expect);
+}
+
+TEST(WetSim, DryingWithoutSources) {
+    for (int n : kSpans) ExpectSame(Actor{}, n);
+}
+
+TEST(WetSim, DryingNearHeat) {
+    for (int n : kSpans) ExpectSame(Actor{}, n, 3.f);
+}
+
+TEST(WetSim, PartlyWetStart) {
+    Actor a;
+    const float start[4]{0.f, 0.35f, 0.8f, 0.05f};
+    std::copy(std::begin(start), std::end(start), a.cat);
+    for (int n : kSpans) ExpectSame(a, n);
+}
+
+TEST(WetSim, PermanentSourceInEveryBlendMode) {
+    for (int mode = 0; mode < 3; ++mode) {
+        Actor a;
+        a.sources["ext.a"] = {0.4f, -1.f, 0x05, 0};
+        a.sources["ext.b"] = {0.25f, -1.f, 0x03, 0};
+        for (int n : kSpans) ExpectSame(a, n, 1.f, MakeConfig(mode));
+
+        Actor dry;
+        std::fill(std::begin(dry.cat), std::end(dry.cat), 0.f);
+        dry.sources = a.sources;
+        for (int n : kSpans) ExpectSame(dry, n, 1.f, MakeConfig(mode));
+    }
+}
+
+TEST(WetSim, SourcesRunningOutMidInterval) {
+    for (int mode = 0; mode < 3; ++mode) {
+        Actor a;
+        a.sources["short"] = {0.9f, 3.1f, 0x0F, 0};
+        a.sources["medium"] = {0.5f, 45.f, 0x06, 0};
+        a.sources["long"] = {0.3f, 140.f, 0x01, 0};
+        for (int n : kSpans) ExpectSame(a, n, 1.f, MakeConfig(mode));
+    }
+}
+
+TEST(WetSim, PassthroughAddsEveryStep) {
+    Actor a;
+    std::fill(std::begin(a.cat), std::end(a.cat), 0.f);
+    a.sources["pt"] = {0.001f, 60.f, 0x01, Sim::kFlagPassthrough};
+    a.sources["pt.long"] = {0.002f, -1.f, 0x02, Sim::kFlagPassthrough};
+    for (int n : kSpans) ExpectSame(a, n);
+}
+
+TEST(WetSim, PinnedBases) {
+    Actor a;
+    const float last[4]{0.6f, 0.6f, 0.3f, -1.f};
+    std::copy(std::begin(last), std::end(last), a.last);
+    a.sources["zero"] = {0.2f, 80.f, 0x01, Sim::kFlagZeroBase};
+    a.sources["hold"] = {0.1f, -1.f, 0x06, Sim::kFlagNoAutoDry};
+    for (int n : kSpans) ExpectSame(a, n);
+}
+
+TEST(WetSim, SplitIntervalsAgree) {
+    // a skip integrated in pieces ends where it does in one go
+    Actor a;
+    a.sources["medium"] = {0.5f, 45.f, 0x06, 0};
+    const Settings::Config cfg = MakeConfig(2);
+
+    Actor once = a, pieces = a;
+    Closed(once, 1500, 1.f, cfg);
+    Closed(pieces, 200, 1.f, cfg);
+    Closed(pieces, 900, 1.f, cfg);
+    Closed(pieces, 400, 1.f, cfg);
+    for (int ci = 0; ci < 4; ++ci) EXPECT_NEAR(once.cat[ci], pieces.cat[ci], kTolerance) << "category " << ci;
+}
+
+TEST(WetSim, SettleFollowsTheEnvironmentClass) {
+    Settings::Config cfg = MakeConfig();
+    cfg.soakWaterRate = 1.f / 8.f;
+    cfg.soakRainRate = 1.f / 60.f;
+    cfg.heatDryMul = 2.5f;
+    cfg.catEnabledMask = 0x07;  // weapons off: they do not count towards the final wetness
+
+    Actor a;
+    const float start[4]{0.2f, 0.5f, 0.1f, 0.9f};
+    std::copy(std::begin(start), std::end(start), a.cat);
+    a.sources["medium"] = {0.3f, 45.f, 0x01, 0};
+    const int steps = 600;
+    const float gap = steps * kStep;
+
+    for (const auto env : {Sim::EnvClass::kDrying, Sim::EnvClass::kNearHeat}) {
+        Actor fine = a;
+        Fine(fine, steps, env == Sim::EnvClass::kNearHeat ? cfg.heatDryMul : 1.f, cfg);
+        Actor settled = a;
+        const float w = Sim::Settle(settled.cat, settled.last, settled.sources, gap, env, kStep, cfg);
+        for (int ci = 0; ci < 4; ++ci) EXPECT_NEAR(settled.cat[ci], fine.cat[ci], kTolerance);
+        EXPECT_FLOAT_EQ(w, std::max({settled.cat[0], settled.cat[1], settled.cat[2]}));
+        EXPECT_EQ(settled.sources.at("medium").expiryRemainingSec, 45.f);  // only read
+    }
+
+    Actor soaked = a;
+    const float w = Sim::Settle(soaked.cat, soaked.last, soaked.sources, 2.f, Sim::EnvClass::kWater, kStep, cfg);
+    for (float c : soaked.cat) EXPECT_FLOAT_EQ(c, 1.f);  // every category from the wettest one, 0.9 + 2 s / 8 s
+    EXPECT_FLOAT_EQ(w, soaked.cat[0]);
+}